@@ -0,0 +1,425 @@
+/*
+	Approximate betweenness implementation, approx.cpp
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Adaptive shortest path sampling, see approx.h
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#include <stdio.h>
+#include <math.h>
+#include <climits>
+#include <omp.h>
+
+#include "approx.h"
+
+/***** Random *****/
+
+/* seed with splitmix64, so nearby seeds give unrelated streams */
+Random::Random(uint64 seed) {
+	uint64 z = seed + 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	state = z ^ (z >> 31);
+	if( state == 0 ) {
+		state = 1;
+	}
+}
+
+uint64 Random::next() {
+	state ^= state >> 12;
+	state ^= state << 25;
+	state ^= state >> 27;
+	return state * 0x2545F4914F6CDD1DULL;
+}
+
+/* uniform in [0,1) */
+double Random::uniform() {
+	return (next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/* uniform in [0,n) */
+int Random::below(int n) {
+	return int( (next() >> 11) % (uint64)n );
+}
+
+/***** PathSampler *****/
+
+PathSampler::PathSampler(Graph &g) {
+	csr1 = g.get_csr1();
+	csr2 = g.get_csr2();
+	num_verts = g.get_num_verts();
+	dist_s = new int[num_verts];
+	dist_t = new int[num_verts];
+	paths_s = new double[num_verts];
+	paths_t = new double[num_verts];
+	queue_s = new int[num_verts];
+	queue_t = new int[num_verts];
+	for(int i=0; i<num_verts; i++) {
+		dist_s[i] = -1;
+		dist_t[i] = -1;
+		paths_s[i] = 0.0;
+		paths_t[i] = 0.0;
+	}
+	tail_s = 0;
+	tail_t = 0;
+	meet_dist = INT_MAX;
+	edges_visited = 0;
+}
+
+PathSampler::~PathSampler() {
+	delete [] dist_s;
+	delete [] dist_t;
+	delete [] paths_s;
+	delete [] paths_t;
+	delete [] queue_s;
+	delete [] queue_t;
+}
+
+long long PathSampler::get_edges_visited() {
+	return edges_visited;
+}
+
+/*
+	Expand one side's frontier, queue_x[front_x..tail_x), by one level.
+	A neighbor already reached by the other side closes a path;
+	the shortest of them are those whose other end is nearest the
+	other root, meet_dist from it, and total accumulates the number
+	of shortest paths through those meeting edges.  Once a meeting edge is found no more nodes are
+	discovered, but the whole level is scanned so total is complete.
+	deg_x becomes the degree sum of the new frontier
+*/
+void PathSampler::expand(int* dist_x, double* paths_x, int* queue_x, int &front_x, int &tail_x, long long &deg_x, int* dist_y, double* paths_y, double &total) {
+
+	int begin = front_x;
+	int end = tail_x;
+	deg_x = 0;
+	for(int i=begin; i<end; i++) {
+		int u = queue_x[i];
+		int next_dist = dist_x[u] + 1;
+		for(eid_t j=csr1[u]; j<csr1[u+1]; j++) {
+			int v = csr2[j];
+			edges_visited++;
+			if( dist_y[v] >= 0 ) {
+				if( dist_y[v] < meet_dist ) {
+					meet_dist = dist_y[v];
+					total = 0.0;
+				}
+				if( dist_y[v] == meet_dist ) {
+					total += paths_x[u] * paths_y[v];
+				}
+			} else if( total == 0.0 ) {
+				if( dist_x[v] < 0 ) {
+					dist_x[v] = next_dist;
+					queue_x[tail_x++] = v;
+					deg_x += csr1[v+1] - csr1[v];
+				}
+				if( dist_x[v] == next_dist ) {
+					paths_x[v] += paths_x[u];
+				}
+			}
+		}
+	}
+	front_x = end;
+}
+
+/*
+	Walk from z back to its side's root, choosing each predecessor
+	with probability proportional to its number of shortest paths.
+	Writes the nodes walked through, excluding the root, to path.
+	Returns the number of nodes written
+*/
+int PathSampler::walk_back(int z, int* dist_x, double* paths_x, Random &rng, int* path) {
+
+	int count = 0;
+	while( dist_x[z] > 0 ) {
+		path[count++] = z;
+		double r = rng.uniform() * paths_x[z];
+		double acc = 0.0;
+		int prev = -1;
+		for(eid_t j=csr1[z]; j<csr1[z+1]; j++) {
+			int p = csr2[j];
+			if( dist_x[p] == dist_x[z] - 1 ) {
+				prev = p;
+				acc += paths_x[p];
+				if( acc > r ) {
+					break;
+				}
+			}
+		}
+		z = prev;
+	}
+	return count;
+}
+
+/* restore the nodes touched by the last sample */
+void PathSampler::reset() {
+	for(int i=0; i<tail_s; i++) {
+		dist_s[queue_s[i]] = -1;
+		paths_s[queue_s[i]] = 0.0;
+	}
+	for(int i=0; i<tail_t; i++) {
+		dist_t[queue_t[i]] = -1;
+		paths_t[queue_t[i]] = 0.0;
+	}
+	tail_s = 0;
+	tail_t = 0;
+}
+
+/*
+	Sample a uniformly random shortest path from s to t,
+	growing the side whose frontier has the smaller degree sum.
+	Writes the interior nodes of the path, those other than s and t,
+	to path and returns how many there are, or -1 if t is unreachable
+*/
+int PathSampler::sample(int s, int t, Random &rng, int* path) {
+
+	if( s == t ) {
+		return -1;
+	}
+
+	dist_s[s] = 0;
+	paths_s[s] = 1.0;
+	queue_s[tail_s++] = s;
+	dist_t[t] = 0;
+	paths_t[t] = 1.0;
+	queue_t[tail_t++] = t;
+
+	int front_s = 0;
+	int front_t = 0;
+	long long deg_s = csr1[s+1] - csr1[s];
+	long long deg_t = csr1[t+1] - csr1[t];
+	double total = 0.0;
+	bool from_s = true;
+	meet_dist = INT_MAX;
+
+	while( total == 0.0 && front_s < tail_s && front_t < tail_t ) {
+		if( deg_s <= deg_t ) {
+			from_s = true;
+			expand(dist_s, paths_s, queue_s, front_s, tail_s, deg_s, dist_t, paths_t, total);
+		} else {
+			from_s = false;
+			expand(dist_t, paths_t, queue_t, front_t, tail_t, deg_t, dist_s, paths_s, total);
+		}
+	}
+
+	if( total == 0.0 ) {
+		reset();
+		return -1;
+	}
+
+	/*
+		Pick a meeting edge (x,y) with probability proportional
+		to the shortest paths through it, by rescanning the level
+		that was just expanded, the nodes with the frontier's distance
+	*/
+	int* dist_x = from_s ? dist_s : dist_t;
+	double* paths_x = from_s ? paths_s : paths_t;
+	int* queue_x = from_s ? queue_s : queue_t;
+	int* dist_y = from_s ? dist_t : dist_s;
+	double* paths_y = from_s ? paths_t : paths_s;
+	int level_end = from_s ? front_s : front_t;
+
+	double r = rng.uniform() * total;
+	double acc = 0.0;
+	int x = -1;
+	int y = -1;
+	int level = dist_x[queue_x[level_end-1]];
+	for(int i=level_end-1; i>=0 && dist_x[queue_x[i]] == level && acc <= r; i--) {
+		int u = queue_x[i];
+		for(eid_t j=csr1[u]; j<csr1[u+1]; j++) {
+			int v = csr2[j];
+			if( dist_y[v] == meet_dist ) {
+				x = u;
+				y = v;
+				acc += paths_x[u] * paths_y[v];
+				if( acc > r ) {
+					break;
+				}
+			}
+		}
+	}
+
+	int count = walk_back(x, dist_x, paths_x, rng, path);
+	count += walk_back(y, dist_y, paths_y, rng, path+count);
+
+	reset();
+	return count;
+}
+
+/***** KADABRA *****/
+
+/*
+	Upper bound on the vertex diameter, the most nodes on any
+	shortest path: 2 * eccentricity + 1 of one node per component
+*/
+int vertex_diameter_bound(Graph &g) {
+
+	eid_t* csr1 = g.get_csr1();
+	int* csr2 = g.get_csr2();
+	int num_verts = g.get_num_verts();
+	int* dist = new int[num_verts];
+	int* queue = new int[num_verts];
+	for(int i=0; i<num_verts; i++) {
+		dist[i] = -1;
+	}
+
+	int bound = 1;
+	for(int root=0; root<num_verts; root++) {
+		if( dist[root] >= 0 ) {
+			continue;
+		}
+		int head = 0;
+		int tail = 0;
+		dist[root] = 0;
+		queue[tail++] = root;
+		int ecc = 0;
+		while( head < tail ) {
+			int u = queue[head++];
+			ecc = dist[u];
+			for(eid_t j=csr1[u]; j<csr1[u+1]; j++) {
+				int v = csr2[j];
+				if( dist[v] < 0 ) {
+					dist[v] = dist[u] + 1;
+					queue[tail++] = v;
+				}
+			}
+		}
+		if( 2*ecc + 1 > bound ) {
+			bound = 2*ecc + 1;
+		}
+	}
+
+	delete [] dist;
+	delete [] queue;
+	return bound;
+}
+
+/*
+	Largest deviation, below and above, of an estimate b from its
+	normalized betweenness after tau of at most omega samples,
+	at failure probability exp(-log_inv_delta); Theorem 7 of KADABRA
+*/
+double kadabra_f(double b, double log_inv_delta, double omega, double tau) {
+	double a = 1.0/3.0 - omega/tau;
+	return log_inv_delta/tau * ( a + sqrt( a*a + 2.0*b*omega/log_inv_delta ) );
+}
+
+double kadabra_g(double b, double log_inv_delta, double omega, double tau) {
+	double a = 1.0/3.0 + omega/tau;
+	return log_inv_delta/tau * ( a + sqrt( a*a + 2.0*b*omega/log_inv_delta ) );
+}
+
+/*
+	The number of samples after which every estimate is within
+	epsilon with probability 1 - delta/2, from the vertex diameter
+*/
+long long kadabra_omega(int vertex_diameter, double epsilon, double delta) {
+	int vd = (vertex_diameter > 3) ? vertex_diameter - 2 : 1;
+	double bits = floor( log2( double(vd) ) ) + 1;
+	return (long long)ceil( 0.5/(epsilon*epsilon) * ( bits + log(2.0/delta) ) );
+}
+
+/*
+	Estimate betweenness centrality by sampling shortest paths.
+
+	Threads sample independently into shared counts.
+	The bounds f and g grow with the estimate, and every node is
+	given the same failure probability delta/(4n), so the stopping
+	condition only needs the largest count.  Each thread checks it
+	every few samples, and the achieved bound is recomputed exactly
+	once all threads stop.
+*/
+int kadabra(Graph &g, float* centrality, BrandesOptions &opts, ApproxResult &res) {
+
+	int num_verts = g.get_num_verts();
+	double epsilon = opts.approx_epsilon;
+	double delta = opts.approx_delta;
+
+	res.epsilon = epsilon;
+	res.delta = delta;
+	res.samples = 0;
+	res.vertex_diameter = vertex_diameter_bound(g);
+	res.omega = kadabra_omega(res.vertex_diameter, epsilon, delta);
+	if( num_verts < 2 ) {
+		return 0;
+	}
+
+	double omega = res.omega;
+	double log_inv_delta = log( 4.0*num_verts/delta );
+	int* counts = new int[num_verts];
+	for(int i=0; i<num_verts; i++) {
+		counts[i] = 0;
+	}
+	long long samples = 0;
+	int max_count = 0;
+	bool done = false;
+
+	#pragma omp parallel
+	{
+		Random rng( opts.seed + omp_get_thread_num() );
+		PathSampler sampler(g);
+		int* path = new int[res.vertex_diameter + 1];
+		bool stop = false;
+
+		while( !stop ) {
+
+			for(int k=0; k<16; k++) {
+				int s = rng.below(num_verts);
+				int t = rng.below(num_verts-1);
+				if( t >= s ) t++;
+				int len = sampler.sample(s, t, rng, path);
+				for(int i=0; i<len; i++) {
+					int c;
+					#pragma omp atomic capture
+					c = ++counts[path[i]];
+					while( c > max_count ) {
+						int old = max_count;
+						if( __sync_bool_compare_and_swap(&max_count, old, c) ) break;
+					}
+				}
+			}
+
+			long long tau;
+			#pragma omp atomic capture
+			tau = samples += 16;
+
+			if( tau >= res.omega ) {
+				stop = true;
+			} else {
+				double b = double(max_count) / tau;
+				if( kadabra_f(b, log_inv_delta, omega, tau) < epsilon && kadabra_g(b, log_inv_delta, omega, tau) < epsilon ) {
+					stop = true;
+				}
+			}
+			if( stop ) {
+				#pragma omp atomic write
+				done = true;
+			}
+			#pragma omp atomic read
+			stop = done;
+		}
+
+		delete [] path;
+	}
+
+	// the bound achieved by the final samples
+	double tau = samples;
+	double b = double(max_count) / tau;
+	double bound = kadabra_f(b, log_inv_delta, omega, tau);
+	double upper = kadabra_g(b, log_inv_delta, omega, tau);
+	if( upper > bound ) bound = upper;
+	if( samples >= res.omega && epsilon < bound ) bound = epsilon;
+	res.epsilon = bound;
+	res.samples = samples;
+
+	double scale = 0.5 * double(num_verts) * (num_verts-1) / tau;
+	for(int i=0; i<num_verts; i++) {
+		centrality[i] = counts[i] * scale;
+	}
+
+	delete [] counts;
+	return 0;
+}
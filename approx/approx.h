@@ -0,0 +1,150 @@
+/*
+	Approximate betweenness header, approx.h
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Estimates betweenness without a search from every node.
+
+	kadabra - samples random shortest paths, in the style of KADABRA
+		(M. Borassi and E. Natale. KADABRA is an ADaptive Algorithm
+		for Betweenness via Random Approximation. ESA, 2016).
+		A sample picks a random pair of nodes s, t and a uniformly
+		random shortest path between them, found with a balanced
+		bidirectional BFS, and counts the path's interior nodes.
+		Sampling stops as soon as every estimate is within epsilon
+		of its normalized betweenness with probability 1 - delta,
+		and at the latest after omega samples, the worst case bound
+		from the vertex diameter.
+
+	topk - identifies the k nodes of highest betweenness by the same
+		path sampling, with a confidence interval for each node.
+		Sampling stops once the intervals of the top k are above
+		every other node's, and disjoint from each other, so the
+		ranking is certain, or when ties leave the intervals
+		narrower than epsilon.
+
+	brandes_pivots - runs the exact per-source search and
+		accumulation from only K pivot sources, chosen uniformly,
+		by degree, or from a file, and scales their dependencies
+		up to the whole graph.  Each pair's dependency is weighted
+		by how far the node lies from the pivot, the linear scaling
+		of R. Geisberger, P. Sanders and D. Schultes.  Better
+		Approximation of Betweenness Centrality.  ALENEX, 2008,
+		so nodes near a pivot are not overestimated.
+		Runtime is linear in K.
+
+	Normalized betweenness is the fraction of ordered pairs of nodes
+	whose shortest paths pass through a node.  Estimates are scaled
+	by n(n-1)/2 to match the exact program output, so the absolute
+	error bound is epsilon * n(n-1)/2.
+
+	kadabra searches are unweighted; edge weights are ignored.
+	brandes_pivots uses the engine of the exact computation.
+
+	This software is distributed under 
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#ifndef APPROX_H
+#define APPROX_H
+
+#include "graph.h"
+#include "brandes.h"
+
+typedef unsigned long long uint64;
+
+enum PivotStrategy {
+	PIVOT_UNIFORM,
+	PIVOT_DEGREE,
+	PIVOT_FILE
+};
+
+/*
+	xorshift64* pseudo-random numbers,
+	one generator per thread
+*/
+class Random {
+
+	public:
+		Random(uint64);
+		uint64 next();
+		double uniform();
+		int below(int);
+
+	private:
+		uint64 state;
+
+};
+
+/*
+	Per-thread balanced bidirectional BFS, for sampling
+	a uniformly random shortest path between two nodes.
+	Only the nodes touched by a sample are reset after it
+*/
+class PathSampler {
+
+	public:
+		PathSampler(Graph&);
+		~PathSampler();
+
+		int sample(int, int, Random&, int*);
+		long long get_edges_visited();
+
+	private:
+		void expand(int*, double*, int*, int&, int&, long long&, int*, double*, double&);
+		int walk_back(int, int*, double*, Random&, int*);
+		void reset();
+
+		eid_t* csr1;
+		int* csr2;
+		int num_verts;
+
+		int* dist_s;
+		int* dist_t;
+		double* paths_s;
+		double* paths_t;
+		int* queue_s;
+		int* queue_t;
+		int tail_s;
+		int tail_t;
+		int meet_dist;
+		long long edges_visited;
+
+};
+
+/* what an approximation achieved, for the output file */
+struct ApproxResult {
+	double epsilon;
+	double delta;
+	long long samples;
+	long long omega;
+	int vertex_diameter;
+};
+
+/*
+	The top k nodes, in decreasing estimated betweenness,
+	each with its estimate and confidence interval.
+	separated - the top k lie above every other node
+	ranked - the top k are also in their true order
+*/
+struct TopKResult {
+	int k;
+	int* nodes;
+	float* score;
+	float* lower;
+	float* upper;
+	bool separated;
+	bool ranked;
+	ApproxResult approx;
+};
+
+int vertex_diameter_bound(Graph&);
+double kadabra_f(double, double, double, double);
+double kadabra_g(double, double, double, double);
+long long kadabra_omega(int, double, double);
+int kadabra(Graph&, float*, BrandesOptions&, ApproxResult&);
+int topk(Graph&, int, BrandesOptions&, TopKResult&);
+int choose_pivots(Graph&, BrandesOptions&, int*, float*);
+int brandes_pivots(Graph&, float*, BrandesOptions&);
+const char* pivot_strategy_name(int);
+
+#endif
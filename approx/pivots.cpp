@@ -0,0 +1,185 @@
+/*
+	Pivot betweenness implementation, pivots.cpp
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Estimate betweenness from the dependencies of K pivot sources,
+	see approx.h
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#include <stdio.h>
+#include <cstdlib>
+#include <fstream>
+#include <omp.h>
+
+#include "approx.h"
+#include "reduction.h"
+
+using namespace std;
+
+const char* pivot_strategy_name(int strategy) {
+	switch( strategy ) {
+		case PIVOT_DEGREE:
+			return "degree-proportional";
+		case PIVOT_FILE:
+			return "from file";
+		default:
+			return "uniform";
+	}
+}
+
+/*
+	Count how many times each node is chosen as a pivot.
+	Returns the number of pivots chosen, K
+*/
+static int count_pivots(Graph &g, BrandesOptions &opts, int* counts) {
+
+	int num_verts = g.get_num_verts();
+	eid_t* csr1 = g.get_csr1();
+	Random rng(opts.seed);
+
+	if( opts.pivot_strategy == PIVOT_FILE ) {
+		ifstream in(opts.pivot_file);
+		if( !in.is_open() ) {
+			printf("cannot open pivot file: %s\n", opts.pivot_file);
+			exit(1);
+		}
+		// pivots are given by original id, see Graph::find_vertex
+		int k = 0;
+		unsigned long long id;
+		while( in >> id ) {
+			int node = g.find_vertex(id);
+			if( node < 0 ) {
+				printf("pivot not in graph: %llu\n", id);
+				exit(1);
+			}
+			counts[node]++;
+			k++;
+		}
+		return k;
+	}
+
+	if( opts.pivot_strategy == PIVOT_DEGREE ) {
+		// with replacement, by binary search on the degree prefix sums, csr1
+		long long total = csr1[num_verts];
+		if( total == 0 ) {
+			return 0;
+		}
+		for(int k=0; k<opts.num_sources; k++) {
+			long long r = (long long)( rng.uniform() * total );
+			int lo = 0;
+			int hi = num_verts - 1;
+			while( lo < hi ) {
+				int mid = (lo + hi) / 2;
+				if( csr1[mid+1] <= r ) {
+					lo = mid + 1;
+				} else {
+					hi = mid;
+				}
+			}
+			counts[lo]++;
+		}
+		return opts.num_sources;
+	}
+
+	// uniform, without replacement, by a partial Fisher-Yates shuffle
+	int k = (opts.num_sources < num_verts) ? opts.num_sources : num_verts;
+	int* order = new int[num_verts];
+	for(int i=0; i<num_verts; i++) {
+		order[i] = i;
+	}
+	for(int i=0; i<k; i++) {
+		int j = i + rng.below(num_verts - i);
+		int tmp = order[i];
+		order[i] = order[j];
+		order[j] = tmp;
+		counts[order[i]]++;
+	}
+	delete [] order;
+	return k;
+}
+
+/*
+	Choose pivots into pivots, with the factor each one's
+	dependencies are scaled by into scales; both arrays hold
+	num_verts entries.  A node chosen c times of K is scaled
+	by c / (K p), with p its probability of being chosen, so
+	the estimate is unbiased.  Returns the number of distinct pivots
+*/
+int choose_pivots(Graph &g, BrandesOptions &opts, int* pivots, float* scales) {
+
+	int num_verts = g.get_num_verts();
+	int* counts = new int[num_verts];
+	for(int i=0; i<num_verts; i++) {
+		counts[i] = 0;
+	}
+	int k = count_pivots(g, opts, counts);
+
+	int num_pivots = 0;
+	if( k > 0 ) {
+		double num_dir_edges = g.get_num_dir_edges();
+		for(int i=0; i<num_verts; i++) {
+			if( counts[i] == 0 ) {
+				continue;
+			}
+			double p = 1.0 / num_verts;
+			if( opts.pivot_strategy == PIVOT_DEGREE ) {
+				p = g.get_degree(i) / num_dir_edges;
+			}
+			pivots[num_pivots] = i;
+			scales[num_pivots] = float( counts[i] / (k * p) );
+			num_pivots++;
+		}
+	}
+
+	delete [] counts;
+	return num_pivots;
+}
+
+/*
+	Estimate betweenness centrality from pivot sources.
+
+	Each pivot runs the per-source search and accumulation of the
+	exact engine, with linear scaling: the dependency of a pair s, t
+	on a node v is weighted by d(s,v) / d(s,t).  The weights of
+	the two ends of a pair sum to 1, so unlike the exact computation
+	the dependencies are not halved.  Weighted graphs use the
+	Dijkstra engine, with a Workspace per thread, even where
+	the exact computation would use delta-stepping.
+*/
+int brandes_pivots(Graph &g, float* centrality, BrandesOptions &opts) {
+
+	int num_verts = g.get_num_verts();
+	int* pivots = new int[num_verts];
+	float* scales = new float[num_verts];
+	int num_pivots = choose_pivots(g, opts, pivots, scales);
+	int engine = choose_engine(g, opts);
+	bool weighted = ( engine == ENGINE_DIJKSTRA || engine == ENGINE_DELTA_STEPPING );
+
+	CentralityReduction red(centrality, num_verts, opts.reduce_mode, opts.mem_budget_mb);
+
+	#pragma omp parallel
+	{
+		Workspace ws(num_verts);
+		RadixHeap heap;
+		float* acc = red.thread_begin();
+		bool atomic = red.is_atomic();
+
+		#pragma omp for schedule(dynamic, 1)
+		for(int i=0; i<num_pivots; i++) {
+			if( weighted ) {
+				brandes_dijkstra_source(g, ws, heap, pivots[i], acc, atomic, scales[i], true, NULL, NULL);
+			} else {
+				brandes_bfs_source(g, ws, pivots[i], acc, atomic, scales[i], true, opts.bfs_direction, NULL, NULL);
+			}
+		}
+
+		red.thread_end();
+	}
+
+	delete [] pivots;
+	delete [] scales;
+	return num_pivots;
+}
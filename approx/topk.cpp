@@ -0,0 +1,187 @@
+/*
+	Top-k betweenness implementation, topk.cpp
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Identify the k nodes of highest betweenness by progressive
+	shortest path sampling, see approx.h
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#include <stdio.h>
+#include <cstdlib>
+#include <math.h>
+#include <omp.h>
+
+#include "approx.h"
+
+/* for sorting nodes by decreasing count, ties by node id */
+static int* sort_counts;
+
+static int compare_by_count(const void* a, const void* b) {
+	int x = *(const int*)a;
+	int y = *(const int*)b;
+	if( sort_counts[x] != sort_counts[y] ) return (sort_counts[x] > sort_counts[y]) ? -1 : 1;
+	return (x < y) ? -1 : (x > y);
+}
+
+/*
+	Find the top k nodes, with their lower and upper bounds
+	on normalized betweenness after tau samples, and whether
+	they are separated from the rest and ranked.
+	Returns true if sampling can stop: the top k are ranked,
+	or every interval still overlapping a neighbor's, which
+	may be a tie, is narrower than epsilon
+*/
+static bool check_topk(int* counts, int* order, int num_verts, int k, double tau,
+		double log_inv_delta, double omega, double epsilon, TopKResult &res) {
+
+	sort_counts = counts;
+	qsort( order, num_verts, sizeof(int), compare_by_count );
+
+	for(int i=0; i<k; i++) {
+		double b = counts[order[i]] / tau;
+		double lo = b - kadabra_f(b, log_inv_delta, omega, tau);
+		res.nodes[i] = order[i];
+		res.score[i] = b;
+		res.lower[i] = (lo > 0.0) ? lo : 0.0;
+		res.upper[i] = b + kadabra_g(b, log_inv_delta, omega, tau);
+	}
+
+	// upper bounds grow with the count, so the (k+1)th is the largest of the rest
+	double rest_upper = 0.0;
+	double rest_width = 0.0;
+	if( k < num_verts ) {
+		double b = counts[order[k]] / tau;
+		rest_upper = b + kadabra_g(b, log_inv_delta, omega, tau);
+		rest_width = kadabra_f(b, log_inv_delta, omega, tau) + kadabra_g(b, log_inv_delta, omega, tau);
+	}
+
+	double widest = 0.0;
+	res.separated = true;
+	res.ranked = true;
+	for(int i=0; i<k; i++) {
+		bool overlap = false;
+		if( i > 0 && res.lower[i-1] <= res.upper[i] ) overlap = true;
+		if( i < k-1 && res.lower[i] <= res.upper[i+1] ) overlap = true;
+		if( k < num_verts && res.lower[i] <= rest_upper ) {
+			res.separated = false;
+			overlap = true;
+			if( rest_width > widest ) widest = rest_width;
+		}
+		if( overlap ) {
+			res.ranked = false;
+			if( res.upper[i] - res.lower[i] > widest ) widest = res.upper[i] - res.lower[i];
+		}
+	}
+	res.ranked = res.ranked && res.separated;
+
+	return res.ranked || widest < epsilon;
+}
+
+/*
+	Identify the top k nodes by betweenness.
+
+	Threads sample shortest paths in rounds into shared counts.
+	After each round the top k are checked against the bounds of
+	KADABRA, with failure probability delta/(4n) per node, and
+	rounds grow geometrically so the O(n log n) check stays cheap.
+	Sampling stops once the top k are separated and ranked, when
+	the intervals left overlapping are narrower than epsilon, or after
+	omega samples.  res holds arrays of k entries, allocated here
+	and freed by the caller.  Scores and bounds are scaled by
+	n(n-1)/2 like the exact values
+*/
+int topk(Graph &g, int k, BrandesOptions &opts, TopKResult &res) {
+
+	int num_verts = g.get_num_verts();
+	if( k > num_verts ) k = num_verts;
+	double epsilon = opts.approx_epsilon;
+	double delta = opts.approx_delta;
+
+	res.k = k;
+	res.nodes = new int[k];
+	res.score = new float[k];
+	res.lower = new float[k];
+	res.upper = new float[k];
+	res.separated = false;
+	res.ranked = false;
+	res.approx.epsilon = epsilon;
+	res.approx.delta = delta;
+	res.approx.samples = 0;
+	res.approx.vertex_diameter = vertex_diameter_bound(g);
+	res.approx.omega = kadabra_omega(res.approx.vertex_diameter, epsilon, delta);
+	if( num_verts < 2 || k < 1 ) {
+		return 0;
+	}
+
+	double omega = res.approx.omega;
+	double log_inv_delta = log( 4.0*num_verts/delta );
+	int* counts = new int[num_verts];
+	int* order = new int[num_verts];
+	for(int i=0; i<num_verts; i++) {
+		counts[i] = 0;
+		order[i] = i;
+	}
+	long long samples = 0;
+	long long round = (res.approx.omega < 1024) ? res.approx.omega : 1024;
+	bool done = false;
+
+	#pragma omp parallel
+	{
+		Random rng( opts.seed + omp_get_thread_num() );
+		PathSampler sampler(g);
+		int* path = new int[res.approx.vertex_diameter + 1];
+
+		while( !done ) {
+
+			#pragma omp for schedule(dynamic, 64)
+			for(long long r=0; r<round; r++) {
+				int s = rng.below(num_verts);
+				int t = rng.below(num_verts-1);
+				if( t >= s ) t++;
+				int len = sampler.sample(s, t, rng, path);
+				for(int i=0; i<len; i++) {
+					#pragma omp atomic
+					counts[path[i]]++;
+				}
+			}
+
+			#pragma omp single
+			{
+				samples += round;
+				done = check_topk(counts, order, num_verts, k, samples, log_inv_delta, omega, epsilon, res);
+				if( samples >= res.approx.omega ) {
+					done = true;
+				}
+				round = samples / 4;
+				if( samples + round > res.approx.omega ) {
+					round = res.approx.omega - samples;
+				}
+			}
+		}
+
+		delete [] path;
+	}
+
+	// the widest interval reported, as a bound on normalized betweenness
+	double bound = 0.0;
+	for(int i=0; i<k; i++) {
+		if( res.upper[i] - res.score[i] > bound ) bound = res.upper[i] - res.score[i];
+		if( res.score[i] - res.lower[i] > bound ) bound = res.score[i] - res.lower[i];
+	}
+	res.approx.epsilon = bound;
+	res.approx.samples = samples;
+
+	double pairs = 0.5 * double(num_verts) * (num_verts-1);
+	for(int i=0; i<k; i++) {
+		res.score[i] *= pairs;
+		res.lower[i] *= pairs;
+		res.upper[i] *= pairs;
+	}
+
+	delete [] counts;
+	delete [] order;
+	return 0;
+}
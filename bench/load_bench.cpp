@@ -0,0 +1,97 @@
+/*
+	Graph load benchmark, load_bench.cpp
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Times loading a graph, without computing betweenness,
+	against a plain read of the same file, to show how close
+	parsing comes to the rate the file can be read at.
+
+	usage, from the main directory after make load_bench:
+
+		OMP_NUM_THREADS=T ./bench/load_bench  [ingraph]  [repeats]
+
+	Each repeat reads the file, then loads it as a Graph; the
+	best time of each is reported.  Repeats after the first
+	read from the page cache; drop it between runs to include
+	the disk.
+
+	This software is distributed under 
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <sys/time.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <omp.h>
+
+#include "graph.h"
+
+typedef unsigned long long uint64;
+
+uint64 getTimeUs64() {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return uint64(tv.tv_sec)*1000000 + tv.tv_usec;
+}
+
+/* read the whole file in large blocks, returning the bytes read */
+long long read_file(const char* infile, char* buffer, size_t buffer_size) {
+	int fd = open( infile, O_RDONLY );
+	if( fd < 0 ) {
+		printf("cannot open %s\n", infile);
+		exit(1);
+	}
+	long long total = 0;
+	ssize_t got;
+	while( (got = read(fd, buffer, buffer_size)) > 0 ) {
+		total += got;
+	}
+	close(fd);
+	return total;
+}
+
+int main(int argc, char* argv[]) {
+
+	if( argc < 2 ) {
+		printf("usage: ./bench/load_bench  [ingraph]  [repeats]\n");
+		return -1;
+	}
+	const char* infile = argv[1];
+	int repeats = (argc > 2) ? atoi(argv[2]) : 5;
+
+	size_t buffer_size = 1 << 24;
+	char* buffer = (char*)malloc(buffer_size);
+	uint64 best_read = 0;
+	uint64 best_load = 0;
+	long long bytes = 0;
+	int num_verts = 0;
+	long long num_edges = 0;
+	bool mapped = false;
+
+	for(int r=0; r<repeats; r++) {
+		uint64 start = getTimeUs64();
+		bytes = read_file(infile, buffer, buffer_size);
+		uint64 mid = getTimeUs64();
+		Graph g(infile);
+		uint64 end = getTimeUs64();
+
+		num_verts = g.get_num_verts();
+		num_edges = g.get_num_undir_edges();
+		mapped = g.is_mapped();
+		if( r == 0 || mid-start < best_read ) best_read = mid-start;
+		if( r == 0 || end-mid < best_load ) best_load = end-mid;
+	}
+	free(buffer);
+
+	double mb = bytes / (1024.0*1024.0);
+	printf("graph %s: %d vertices, %lld edges, %.1f MB%s\n", infile, num_verts, num_edges, mb, mapped ? ", binary" : "");
+	printf("threads %d, best of %d\n", omp_get_max_threads(), repeats);
+	printf("%-8s %10s %10s\n", "", "ms", "MB/s");
+	printf("%-8s %10.2f %10.1f\n", "read", best_read/1000.0, mb / (best_read/1e6));
+	printf("%-8s %10.2f %10.1f\n", "load", best_load/1000.0, mb / (best_load/1e6));
+
+	return 0;
+}
@@ -0,0 +1,126 @@
+/*
+	Prefetch benchmark, prefetch_bench.cpp
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Times Brandes from a sample of sources on one thread, with
+	the top-down BFS engine, then with the interleaved engine at
+	1, 2, 4, ... lanes, without and with software prefetch, to
+	show how much of the time per edge is spent waiting on
+	memory and how much interleaving hides.
+
+	usage, from the main directory after make prefetch_bench:
+
+		./bench/prefetch_bench  [ingraph]  [sources]  [max_lanes]
+
+	Sources are spread evenly over the node ids, default 16,
+	and lanes double up to max_lanes, default 16.  Every run
+	examines the same edges, so the gain shows as fewer
+	nanoseconds per edge; it appears once the graph and the
+	search state of the lanes exceed the last level cache,
+	whose size is printed beside the graph's.  Each run's
+	centrality is checked against the BFS engine's.
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "graph.h"
+#include "workspace.h"
+#include "brandes.h"
+#include "interleave.h"
+
+uint64 getTimeUs64() {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return uint64(tv.tv_sec)*1000000 + tv.tv_usec;
+}
+
+/* largest difference of b from a, relative to the largest value of a */
+double max_difference(float* a, float* b, int n) {
+	double largest = 0.0;
+	double diff = 0.0;
+	for(int i=0; i<n; i++) {
+		if( fabs(a[i]) > largest ) largest = fabs(a[i]);
+		if( fabs(a[i]-b[i]) > diff ) diff = fabs(a[i]-b[i]);
+	}
+	return largest > 0.0 ? diff / largest : diff;
+}
+
+int main(int argc, char* argv[]) {
+
+	if( argc < 2 ) {
+		printf("usage: ./bench/prefetch_bench  [ingraph]  [sources]  [max_lanes]\n");
+		return -1;
+	}
+	const char* infile = argv[1];
+	int num_sources = (argc > 2) ? atoi(argv[2]) : 16;
+	int max_lanes = (argc > 3) ? atoi(argv[3]) : 16;
+
+	Graph g(infile);
+	int num_verts = g.get_num_verts();
+	if( num_sources < 1 || num_sources > num_verts ) {
+		num_sources = num_verts;
+	}
+	int* sources = new int[num_sources];
+	for(int i=0; i<num_sources; i++) {
+		sources[i] = int( (long long)i * num_verts / num_sources );
+	}
+
+	double graph_mb = ( (num_verts+1.0)*sizeof(eid_t) + double(g.get_num_dir_edges())*sizeof(int) ) / (1024.0*1024.0);
+	double state_mb = num_verts * (2*sizeof(int) + sizeof(sigma_t) + sizeof(float)) / (1024.0*1024.0);
+	long llc = sysconf(_SC_LEVEL3_CACHE_SIZE);
+	printf("graph %s: %d vertices, %lld edges\n", infile, num_verts, (long long)g.get_num_undir_edges());
+	printf("csr %.1f MB, search state %.1f MB per lane, last level cache %.1f MB\n", graph_mb, state_mb, llc > 0 ? llc/(1024.0*1024.0) : 0.0);
+	printf("%d sources, one thread\n", num_sources);
+
+	float* expected = new float[num_verts];
+	float* centrality = new float[num_verts];
+	for(int i=0; i<num_verts; i++) {
+		expected[i] = 0.0;
+	}
+
+	Workspace ws(num_verts);
+	uint64 start = getTimeUs64();
+	for(int i=0; i<num_sources; i++) {
+		brandes_bfs_source(g, ws, sources[i], expected, false, 1.0, false, BFS_TOP_DOWN, NULL, NULL);
+	}
+	uint64 bfs_time = getTimeUs64() - start;
+
+	// forward and backward, each source reads every reached row twice
+	InterleavedBFS count(g, 1, false);
+	for(int i=0; i<num_verts; i++) {
+		centrality[i] = 0.0;
+	}
+	count.run(sources, num_sources, centrality, false, 1.0);
+	long long edges = count.get_edges_examined();
+
+	printf("%-12s %8s %10s %10s %8s %10s\n", "engine", "lanes", "ms", "ns/edge", "speedup", "max diff");
+	printf("%-12s %8d %10.2f %10.3f %8.2f %10s\n", "bfs", 1, bfs_time/1000.0, 1000.0*bfs_time/edges, 1.0, "-");
+
+	for(int lanes=1; lanes<=max_lanes; lanes*=2) {
+		for(int p=0; p<2; p++) {
+			bool prefetch = (p == 1);
+			for(int i=0; i<num_verts; i++) {
+				centrality[i] = 0.0;
+			}
+			InterleavedBFS ib(g, lanes, prefetch);
+			start = getTimeUs64();
+			ib.run(sources, num_sources, centrality, false, 1.0);
+			uint64 time = getTimeUs64() - start;
+			printf("%-12s %8d %10.2f %10.3f %8.2f %10.2e\n", prefetch ? "prefetch" : "interleaved", lanes,
+				time/1000.0, 1000.0*time/edges, double(bfs_time)/time, max_difference(expected, centrality, num_verts));
+		}
+	}
+
+	delete [] sources;
+	delete [] expected;
+	delete [] centrality;
+
+	return 0;
+}
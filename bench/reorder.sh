@@ -0,0 +1,38 @@
+#!/bin/sh
+#
+#	Graph reordering benchmark, reorder.sh
+#	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+#
+#	Runs betweenness with each vertex order, see reorder/reorder.h,
+#	and prints the time to reorder, the betweenness runtime, the
+#	runtime saved against the order loaded, and the saving net of
+#	the reordering, to decide per graph whether a reorder pays off.
+#	Options after the graph, such as --engine bfs, are passed on.
+#
+#	usage, from the main directory after make:
+#
+#		./bench/reorder.sh  [ingraph]  [options]
+#
+#	This software is distributed under 
+#	the modified Berkeley Software Distribution (BSD) License.
+#
+
+GRAPH=${1:-sample.adjacency_list}
+shift
+OUT=/tmp/reorder_bench.$$
+
+printf "%-10s %10s %12s %10s %10s\n" order reorder_ms runtime_ms saved_ms net_ms
+BASE=""
+for ORDER in none degree rcm community; do
+	LOG=$(./betweenness --reorder $ORDER "$@" $GRAPH $OUT)
+	RT=$(echo "$LOG" | grep "Betweenness Runtime" | awk '{print $3}')
+	RO=$(echo "$LOG" | grep "Reorder time" | awk '{print $3}')
+	RO=${RO:-0}
+	if [ -z "$BASE" ]; then
+		BASE=$RT
+	fi
+	SAVED=$((BASE - RT))
+	printf "%-10s %10d %12d %10d %10d\n" $ORDER $RO $RT $SAVED $((SAVED - RO))
+done
+
+rm -f $OUT
@@ -0,0 +1,37 @@
+#!/bin/sh
+#
+#	Thread scaling benchmark, scaling.sh
+#	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+#
+#	Runs betweenness with 1, 2, 4, ... up to MAX_THREADS threads
+#	for each centrality reduction, and prints the runtime and
+#	speedup over one thread.
+#
+#	usage, from the main directory after make:
+#
+#		./bench/scaling.sh  [ingraph]  [max_threads]
+#
+#	This software is distributed under 
+#	the modified Berkeley Software Distribution (BSD) License.
+#
+
+GRAPH=${1:-sample.adjacency_list}
+MAX_THREADS=${2:-64}
+OUT=/tmp/scaling_bench.$$
+
+printf "%-8s %8s %12s %9s\n" reduce threads runtime_ms speedup
+for MODE in local atomic; do
+	BASE=""
+	T=1
+	while [ $T -le $MAX_THREADS ]; do
+		MS=$(OMP_NUM_THREADS=$T ./betweenness --reduce $MODE $GRAPH $OUT \
+			| grep "Betweenness Runtime" | awk '{print $3}')
+		if [ -z "$BASE" ]; then
+			BASE=$MS
+		fi
+		printf "%-8s %8d %12d %9.2f\n" $MODE $T $MS $(echo "$BASE $MS" | awk '{ if ($2 > 0) print $1/$2; else print 0 }')
+		T=$((T*2))
+	done
+done
+
+rm -f $OUT
@@ -11,21 +11,29 @@
 
 #include <fstream>
 #include <cstdlib>
+#include <cstring>
 #include <sys/time.h>
 #include <iomanip>
 #include <omp.h>
 
 using namespace std;
 
-#include "priority_queue.h"
 #include "graph.h"
-#include "dynamic_array.h"
+#include "brandes.h"
+#include "reduction.h"
+#include "approx.h"
+#include "reorder.h"
+#include "prune.h"
+#include "blocks.h"
+#include "twins.h"
 
-typedef DynamicArray Darray;
 typedef unsigned long long uint64;
 
-int brandes(Graph&, float*);
-void write_outfile(string, float*, int);
+bool parse_options(int, char**, BrandesOptions&, string&, string&, bool&, int&, int&);
+void print_usage();
+void write_outfile(string, float*, Graph&, string);
+void write_topk_outfile(string, TopKResult&, Graph&, string);
+void finish_run(string, float*, TopKResult*, Graph&, string, uint64, uint64);
 uint64 getTimeMs64();
 
 /*
@@ -35,22 +43,41 @@ uint64 getTimeMs64();
 int main(int argc, char* argv[]) {
 
 	// usage and input
-  if(argc != 3) {  
-		printf("usage: ./betweenness  [ingraph]  [outfile]\n");
+	BrandesOptions opts;
+	string graph_str;
+	string outfile_str;
+	bool use_cache = false;
+	int format = FORMAT_AUTO;
+	int reorder = REORDER_NONE;
+	if( !parse_options(argc, argv, opts, graph_str, outfile_str, use_cache, format, reorder) ) {
+		print_usage();
 		return -1;
-  }
-	string graph_str = argv[1];
-	string outfile_str = argv[2];	
+	}
 
 	// timing variables and start
-	uint64 total_start, total_end;
+	uint64 total_start;
 	uint64 btwn_start, btwn_end;
 	printf("Betweenness Centrality begin\n");
 	total_start = getTimeMs64();
 
 	// load graph from inputfile string
-	Graph g(graph_str);
-	printf("Loaded graph with %d vertices and %d edges\n", g.get_num_verts(), g.get_num_undir_edges() );
+	Graph g(graph_str, use_cache, format);
+	printf("Loaded graph with %d vertices and %lld edges\n", g.get_num_verts(), (long long)g.get_num_undir_edges() );
+	if( g.is_mapped() ) {
+		printf("Graph mapped from binary CSR\n");
+	} else {
+		printf("Graph read as %s\n", format_name(g.get_format()) );
+	}
+	uint64 load_end = getTimeMs64();
+	printf("Load time: %llu ms\n", load_end-total_start);
+
+	// renumber for locality, results are still written in the order loaded
+	if( reorder != REORDER_NONE ) {
+		int* order = reorder_order(g, reorder);
+		g.reorder(order);
+		delete [] order;
+		printf("Reorder time: %llu ms, by %s\n", getTimeMs64()-load_end, reorder_name(reorder) );
+	}
 
 	// init centrality
 	float* centrality;
@@ -58,166 +85,418 @@ int main(int argc, char* argv[]) {
 
 	
 
+	// top k
+	if( opts.top_k > 0 ) {
+		if( opts.approx_epsilon <= 0.0 ) {
+			opts.approx_epsilon = 0.001;
+		}
+		printf("Finding the top %d nodes, epsilon %g, delta %g, seed %llu\n", opts.top_k, opts.approx_epsilon, opts.approx_delta, opts.seed);
+		printf("Threads available: %d\n", omp_get_max_threads() );
+		if( g.is_weighted() ) {
+			printf("Ignoring edge weights, every edge has length 1\n");
+		}
+		TopKResult res;
+		btwn_start = getTimeMs64();
+		topk(g, opts.top_k, opts, res);
+		btwn_end = getTimeMs64();
+		printf("Sampled %lld shortest paths, at most %lld needed\n", res.approx.samples, res.approx.omega);
+		printf("Top %d separated from the rest: %s, ranked: %s\n", res.k, res.separated ? "YES" : "NO", res.ranked ? "YES" : "NO");
+
+		char header[512];
+		snprintf(header, sizeof(header),
+			"# top %d betweenness, %lld sampled paths, intervals hold with probability %g\n"
+			"# separated from the rest: %s, ranking certain: %s\n",
+			res.k, res.approx.samples, 1.0-res.approx.delta, res.separated ? "yes" : "no", res.ranked ? "yes" : "no");
+
+		finish_run( outfile_str, centrality, &res, g, header, btwn_end-btwn_start, total_start );
+		delete [] res.nodes;
+		delete [] res.score;
+		delete [] res.lower;
+		delete [] res.upper;
+		return 0;
+	}
+
+	// approximation
+	if( opts.approx_epsilon > 0.0 ) {
+		printf("Approximating with epsilon %g, delta %g, seed %llu\n", opts.approx_epsilon, opts.approx_delta, opts.seed);
+		printf("Threads available: %d\n", omp_get_max_threads() );
+		if( g.is_weighted() ) {
+			printf("Ignoring edge weights, every edge has length 1\n");
+		}
+		ApproxResult res;
+		btwn_start = getTimeMs64();
+		kadabra(g, centrality, opts, res);
+		btwn_end = getTimeMs64();
+		printf("Sampled %lld shortest paths, at most %lld needed\n", res.samples, res.omega);
+		printf("Achieved epsilon %g\n", res.epsilon);
+
+		double pairs = 0.5 * double(g.get_num_verts()) * (g.get_num_verts()-1);
+		char header[512];
+		snprintf(header, sizeof(header),
+			"# approximate betweenness, %lld sampled paths, vertex diameter bound %d\n"
+			"# normalized error at most %g, absolute error at most %.3f, with probability %g\n",
+			res.samples, res.vertex_diameter, res.epsilon, res.epsilon*pairs, 1.0-res.delta);
+
+		finish_run( outfile_str, centrality, NULL, g, header, btwn_end-btwn_start, total_start );
+		return 0;
+	}
+
+	// pivot estimate
+	if( opts.num_sources > 0 || opts.pivot_strategy == PIVOT_FILE ) {
+		int engine = choose_engine(g, opts);
+		printf("Estimating from %s pivots, seed %llu\n", pivot_strategy_name(opts.pivot_strategy), opts.seed);
+		printf("Threads available: %d\n", omp_get_max_threads() );
+		bool weighted = ( engine == ENGINE_DIJKSTRA || engine == ENGINE_DELTA_STEPPING );
+		printf("Shortest paths engine: %s\n", engine_name( weighted ? ENGINE_DIJKSTRA : ENGINE_BFS ) );
+		btwn_start = getTimeMs64();
+		int num_pivots = brandes_pivots(g, centrality, opts);
+		btwn_end = getTimeMs64();
+		printf("Searched from %d distinct pivots\n", num_pivots);
+
+		char header[512];
+		snprintf(header, sizeof(header),
+			"# pivot estimate, %d distinct pivots, %s, linear scaling\n",
+			num_pivots, pivot_strategy_name(opts.pivot_strategy));
+
+		finish_run( outfile_str, centrality, NULL, g, header, btwn_end-btwn_start, total_start );
+		return 0;
+	}
+
 	// threading info
+	int engine = choose_engine(g, opts);
+	if( opts.prune || opts.blocks || opts.twins ) {
+		// the reduced graph is searched a source per thread
+		bool weighted = ( engine == ENGINE_DIJKSTRA || engine == ENGINE_DELTA_STEPPING );
+		engine = weighted ? ENGINE_DIJKSTRA : ENGINE_BFS;
+	}
 	if( omp_get_max_threads() > 1 ) {
 		printf("Running in parallel...   YES\n");
 		printf("Threads available: %d\n", omp_get_max_threads() );
+		int mode = CentralityReduction::choose_mode(opts.reduce_mode, g.get_num_verts(), omp_get_max_threads(), opts.mem_budget_mb);
+		if( engine == ENGINE_DELTA_STEPPING ) {
+			printf("Centrality reduction: none, threads share each source\n");
+		} else if( mode == REDUCE_LOCAL ) {
+			printf("Centrality reduction: thread-local\n");
+		} else {
+			printf("Centrality reduction: atomic\n");
+		}
 	} else {
 		printf("Running in parallel...   NO\n");
 	}
 
 	// run centrality
+	printf("Shortest paths engine: %s\n", engine_name(engine) );
+	if( opts.bfs_direction != BFS_AUTO && engine != ENGINE_BFS ) {
+		printf("Ignoring --bfs-direction, used only by the BFS engine\n");
+	}
+	if( opts.bfs_stats && (engine != ENGINE_BFS || opts.prune || opts.blocks || opts.twins) ) {
+		printf("Ignoring --bfs-stats, printed only by the BFS engine on the whole graph\n");
+	}
+	if( (engine == ENGINE_BFS || engine == ENGINE_MULTI_SOURCE || engine == ENGINE_SPMM || engine == ENGINE_INTERLEAVED) && g.is_weighted() ) {
+		printf("Ignoring edge weights, every edge has length 1\n");
+	}
 	printf("Beginning betweenness centrality computation...\n");	
 	btwn_start = getTimeMs64();
-	brandes(g, centrality);
+	if( opts.blocks ) {
+		brandes_blocks(g, centrality, opts);
+	} else if( opts.prune ) {
+		brandes_pruned(g, centrality, opts);
+	} else if( opts.twins ) {
+		brandes_twins(g, centrality, opts);
+	} else {
+		brandes(g, centrality, opts);
+	}
 	btwn_end = getTimeMs64();
 	printf("Computing complete\n");
 
-	// write results to file
-	printf("Writing output file\n");
-	write_outfile( outfile_str, centrality, g.get_num_verts() );
-	printf("Output complete\n");
-
-	// end
-	total_end = getTimeMs64();
-	printf("Program complete\n");
-	printf("Betweenness Runtime: %d ms\n", btwn_end-btwn_start);
-	printf("Total runtime: %d ms\n", total_end-total_start);
-	
-	free(centrality);
+	// write results to file and end
+	finish_run( outfile_str, centrality, NULL, g, "", btwn_end-btwn_start, total_start );
 
 	return 0;
 
 }
 
 /*
-	Compute betweenness centrality using Brandes method
+	Parse the command line, options first, then the
+	input graph and output file.
+	Returns false if the command line is malformed
 */
-int brandes(Graph &g, float* centrality) {
-
-	int* csr1 = g.get_csr1();
-	int* csr2 = g.get_csr2();
-	int num_verts = g.get_num_verts();
-
-	/* 
-		Compute centrality for each node i.
-		Can be done in parallel
-	*/
-	#pragma omp parallel for shared(centrality)
-	for(int i=0; i<num_verts; i++) {
-
-		// declarations 
-		PriorityQueue Q(num_verts);
-		Darray** parents;
-		int* num_paths;
-		float* delta;
-
-		// initializations
-		Q.init(i);		
-		parents = new Darray*[num_verts];
-		delta = new float[num_verts];
-		num_paths = new int[num_verts];
-		for(int j=0; j< num_verts; j++) {
-			parents[j]=new Darray();
-			delta[j] = 0.0;
-			num_paths[j]=0;
-		}		
-		num_paths[i] = 1;	
-
-		/* 
-			Dijkstra's Single-Source Shortest Path 
-		*/
-		while ( !Q.is_empty() ) {
-						
-			int current_node = Q.top().node;
-			int min_dist = Q.top().dist;
-			Q.pop_min();
-
-			// get neighbors of current node
-			int offset = csr1[current_node];
-			int degree = csr1[current_node+1] - offset;
-			int neighbor;
-			
-			// default edge weight of 1
-			int weight = 1;	
-
-			/*
-				For each neighbor of the current_node,
-				see if a new shortest path is found.
-				If so, update the distance, parent, and position in Q
-			*/
-			for(int j=0; j<degree; j++) {
-				neighbor = csr2[j+offset];
-				if( Q.is_queued(neighbor) ) {
-					int cur_dist = Q.get_dist(neighbor);					
-					if( min_dist + weight < cur_dist ) {
-						Q.update( neighbor, min_dist+weight );
-						(*(parents[neighbor])).push_back(current_node);
-						num_paths[neighbor] = num_paths[current_node];
-					} else if( min_dist + weight == cur_dist ) {
-						(*parents[neighbor]).push_back(current_node);
-						num_paths[neighbor] += num_paths[current_node];
-					}
-				}
+bool parse_options(int argc, char* argv[], BrandesOptions &opts, string &graph_str, string &outfile_str, bool &use_cache, int &format, int &reorder) {
+
+	int i = 1;
+	for( ; i<argc && strncmp(argv[i], "--", 2) == 0; i++) {
+		if( strcmp(argv[i], "--reduce") == 0 && i+1 < argc ) {
+			i++;
+			if( strcmp(argv[i], "auto") == 0 ) {
+				opts.reduce_mode = REDUCE_AUTO;
+			} else if( strcmp(argv[i], "local") == 0 ) {
+				opts.reduce_mode = REDUCE_LOCAL;
+			} else if( strcmp(argv[i], "atomic") == 0 ) {
+				opts.reduce_mode = REDUCE_ATOMIC;
+			} else {
+				printf("unknown reduction: %s\n", argv[i]);
+				return false;
 			}
-		}
-
-		/* 
-			Propogate centrality from earliest discovered nodes to i.
-			The priority_queue Q preserves the order of discovery,
-			then use parents and num_paths to calculate the dependency delta.
-			Delta is added to the centrality.
-		*/		
-		for(int j=0; j<num_verts; j++) {		
-			int childNode = Q[j].node;
-			Darray* parent_nodes = parents[childNode];
-			for(int k=0; k<(*parent_nodes).get_size(); k++) {
-				int parent_node = (*parent_nodes).at(k);
-				if( num_paths[childNode] > 0 ) {					
-					delta[parent_node] += num_paths[parent_node] / float(num_paths[childNode]) * (1 + delta[childNode]);
-				} /*else {
-					printf("error: num paths is 0\n");
-				}*/
+		} else if( strcmp(argv[i], "--mem-budget") == 0 && i+1 < argc ) {
+			opts.mem_budget_mb = atol(argv[++i]);
+		} else if( strcmp(argv[i], "--engine") == 0 && i+1 < argc ) {
+			i++;
+			if( strcmp(argv[i], "auto") == 0 ) {
+				opts.engine = ENGINE_AUTO;
+			} else if( strcmp(argv[i], "bfs") == 0 ) {
+				opts.engine = ENGINE_BFS;
+			} else if( strcmp(argv[i], "dijkstra") == 0 ) {
+				opts.engine = ENGINE_DIJKSTRA;
+			} else if( strcmp(argv[i], "delta-stepping") == 0 ) {
+				opts.engine = ENGINE_DELTA_STEPPING;
+			} else if( strcmp(argv[i], "multi-source") == 0 ) {
+				opts.engine = ENGINE_MULTI_SOURCE;
+			} else if( strcmp(argv[i], "spmm") == 0 ) {
+				opts.engine = ENGINE_SPMM;
+			} else if( strcmp(argv[i], "interleaved") == 0 ) {
+				opts.engine = ENGINE_INTERLEAVED;
+			} else {
+				printf("unknown engine: %s\n", argv[i]);
+				return false;
+			}
+		} else if( strcmp(argv[i], "--delta") == 0 && i+1 < argc ) {
+			opts.bucket_width = atoi(argv[++i]);
+		} else if( strcmp(argv[i], "--ds-stats") == 0 ) {
+			opts.ds_stats = true;
+		} else if( strcmp(argv[i], "--bfs-direction") == 0 && i+1 < argc ) {
+			i++;
+			if( strcmp(argv[i], "auto") == 0 ) {
+				opts.bfs_direction = BFS_AUTO;
+			} else if( strcmp(argv[i], "top-down") == 0 ) {
+				opts.bfs_direction = BFS_TOP_DOWN;
+			} else if( strcmp(argv[i], "bottom-up") == 0 ) {
+				opts.bfs_direction = BFS_BOTTOM_UP;
+			} else {
+				printf("unknown BFS direction: %s\n", argv[i]);
+				return false;
+			}
+		} else if( strcmp(argv[i], "--bfs-stats") == 0 ) {
+			opts.bfs_stats = true;
+		} else if( strcmp(argv[i], "--batch-width") == 0 && i+1 < argc ) {
+			opts.batch_width = atoi(argv[++i]);
+			if( opts.batch_width < 1 ) {
+				printf("batch width must be at least 1: %s\n", argv[i]);
+				return false;
+			}
+		} else if( strcmp(argv[i], "--interleave") == 0 && i+1 < argc ) {
+			opts.interleave_lanes = atoi(argv[++i]);
+			if( opts.interleave_lanes < 1 ) {
+				printf("interleaved lanes must be at least 1: %s\n", argv[i]);
+				return false;
+			}
+		} else if( strcmp(argv[i], "--approx") == 0 && i+1 < argc ) {
+			opts.approx_epsilon = atof(argv[++i]);
+			if( opts.approx_epsilon <= 0.0 || opts.approx_epsilon >= 1.0 ) {
+				printf("epsilon must be between 0 and 1: %s\n", argv[i]);
+				return false;
+			}
+		} else if( strcmp(argv[i], "--approx-delta") == 0 && i+1 < argc ) {
+			opts.approx_delta = atof(argv[++i]);
+			if( opts.approx_delta <= 0.0 || opts.approx_delta >= 1.0 ) {
+				printf("delta must be between 0 and 1: %s\n", argv[i]);
+				return false;
+			}
+		} else if( strcmp(argv[i], "--topk") == 0 && i+1 < argc ) {
+			opts.top_k = atoi(argv[++i]);
+			if( opts.top_k < 1 ) {
+				printf("k must be at least 1: %s\n", argv[i]);
+				return false;
 			}
-			if (childNode != i ) {
-				#pragma omp critical
-				{
-					centrality[childNode] += delta[childNode]/2.0;
-				}
+		} else if( strcmp(argv[i], "--sources") == 0 && i+1 < argc ) {
+			opts.num_sources = atoi(argv[++i]);
+			if( opts.num_sources < 1 ) {
+				printf("sources must be at least 1: %s\n", argv[i]);
+				return false;
 			}
+		} else if( strcmp(argv[i], "--pivots") == 0 && i+1 < argc ) {
+			i++;
+			if( strcmp(argv[i], "uniform") == 0 ) {
+				opts.pivot_strategy = PIVOT_UNIFORM;
+			} else if( strcmp(argv[i], "degree") == 0 ) {
+				opts.pivot_strategy = PIVOT_DEGREE;
+			} else {
+				printf("unknown pivot strategy: %s\n", argv[i]);
+				return false;
+			}
+		} else if( strcmp(argv[i], "--pivot-file") == 0 && i+1 < argc ) {
+			opts.pivot_strategy = PIVOT_FILE;
+			opts.pivot_file = argv[++i];
+		} else if( strcmp(argv[i], "--prune") == 0 ) {
+			opts.prune = true;
+		} else if( strcmp(argv[i], "--blocks") == 0 ) {
+			opts.blocks = true;
+		} else if( strcmp(argv[i], "--twins") == 0 ) {
+			opts.twins = true;
+		} else if( strcmp(argv[i], "--cache") == 0 ) {
+			use_cache = true;
+		} else if( strcmp(argv[i], "--format") == 0 && i+1 < argc ) {
+			i++;
+			if( strcmp(argv[i], "auto") == 0 ) {
+				format = FORMAT_AUTO;
+			} else if( strcmp(argv[i], "adjlist") == 0 ) {
+				format = FORMAT_ADJLIST;
+			} else if( strcmp(argv[i], "edgelist") == 0 ) {
+				format = FORMAT_EDGELIST;
+			} else if( strcmp(argv[i], "mtx") == 0 ) {
+				format = FORMAT_MATRIX_MARKET;
+			} else {
+				printf("unknown graph format: %s\n", argv[i]);
+				return false;
+			}
+		} else if( strcmp(argv[i], "--reorder") == 0 && i+1 < argc ) {
+			i++;
+			if( strcmp(argv[i], "none") == 0 ) {
+				reorder = REORDER_NONE;
+			} else if( strcmp(argv[i], "degree") == 0 ) {
+				reorder = REORDER_DEGREE;
+			} else if( strcmp(argv[i], "rcm") == 0 ) {
+				reorder = REORDER_RCM;
+			} else if( strcmp(argv[i], "community") == 0 ) {
+				reorder = REORDER_COMMUNITY;
+			} else {
+				printf("unknown reordering: %s\n", argv[i]);
+				return false;
+			}
+		} else if( strcmp(argv[i], "--seed") == 0 && i+1 < argc ) {
+			opts.seed = strtoull(argv[++i], NULL, 10);
+		} else {
+			printf("unknown option: %s\n", argv[i]);
+			return false;
 		}
+	}
 
-		// deallocate
-		delete [] delta;
-		delete [] num_paths;
-		for(int j=0; j<num_verts; j++) {
-			delete parents[j];
-		}
-		delete [] parents;
+	if( int(opts.prune) + int(opts.blocks) + int(opts.twins) > 1 ) {
+		printf("choose one of --prune, --blocks and --twins\n");
+		return false;
 	}
+	if( (opts.prune || opts.blocks || opts.twins)
+			&& (opts.approx_epsilon > 0.0 || opts.top_k > 0 || opts.num_sources > 0 || opts.pivot_strategy == PIVOT_FILE) ) {
+		printf("--prune, --blocks and --twins are exact, not combined with --approx, --topk, --sources or --pivot-file\n");
+		return false;
+	}
+	if( argc - i != 2 ) {
+		return false;
+	}
+	graph_str = argv[i];
+	outfile_str = argv[i+1];
+	return true;
+}
 
-	return 0;
+void print_usage() {
+	printf("usage: ./betweenness  [options]  [ingraph]  [outfile]\n");
+	printf("options:\n");
+	printf("  --reduce auto|local|atomic   how threads combine centrality (default auto)\n");
+	printf("  --mem-budget MB              memory for per-thread arrays (default 1024)\n");
+	printf("  --engine auto|bfs|dijkstra|delta-stepping|multi-source|spmm|interleaved\n");
+	printf("                               shortest paths engine (default auto)\n");
+	printf("  --delta N                    delta-stepping bucket width (default mean weight)\n");
+	printf("  --ds-stats                   print delta-stepping relaxations per phase\n");
+	printf("  --bfs-direction auto|top-down|bottom-up\n");
+	printf("                               how BFS levels are expanded (default auto)\n");
+	printf("  --bfs-stats                  print BFS edges examined per level\n");
+	printf("  --batch-width W              sources per spmm batch (default 64)\n");
+	printf("  --interleave K               sources in flight per interleaved thread (default 4)\n");
+	printf("  --approx EPS                 approximate by sampling shortest paths, within\n");
+	printf("                               EPS * n(n-1)/2 of the exact value\n");
+	printf("  --approx-delta D             probability of missing the bound (default 0.1)\n");
+	printf("  --topk K                     find only the top K nodes, by sampling;\n");
+	printf("                               --approx EPS sets how close ties may be (default 0.001)\n");
+	printf("  --sources K                  estimate from K pivot sources\n");
+	printf("  --pivots uniform|degree      how pivots are chosen (default uniform)\n");
+	printf("  --pivot-file FILE            estimate from the pivot node ids in FILE\n");
+	printf("  --prune                      fold trees of degree-1 vertices into the vertices\n");
+	printf("                               they hang from, and search from the rest\n");
+	printf("  --blocks                     search within each biconnected component, with\n");
+	printf("                               the paths through articulation points counted\n");
+	printf("  --twins                      search vertices of the same neighbors once\n");
+	printf("  --seed S                     random seed for sampling (default 1)\n");
+	printf("  --format auto|adjlist|edgelist|mtx\n");
+	printf("                               input graph format (default auto)\n");
+	printf("  --cache                      load a text graph from, or save it to,\n");
+	printf("                               a binary copy beside it, ingraph.bcsr\n");
+	printf("  --reorder none|degree|rcm|community\n");
+	printf("                               renumber vertices for locality after load (default none)\n");
 }
 
 /*
-	Write one node_id and centrality value per line, tab-delimited, to a file
+	Write one node_id and centrality value per line, tab-delimited, to a file,
+	after any header lines, which should begin with #.
+	Nodes are written by their original ids, in the order the graph
+	was loaded, mapping back any reordering of g
 */
-void write_outfile( string str, float* cent, int num_verts ) {
+void write_outfile( string str, float* cent, Graph &g, string header ) {
 
 	ofstream outstream;
 	outstream.open( str.c_str() );
 	
+	outstream << header;
 	outstream << "node\tbetweenness\n";
 
-	for(int i=0; i<num_verts; i++) {
-		outstream << i << "\t" << setprecision(7) << fixed << cent[i]  << endl;
+	int* new_ids = g.get_new_ids();
+	for(int i=0; i<g.get_num_verts(); i++) {
+		int v = (new_ids != NULL) ? new_ids[i] : i;
+		outstream << g.get_orig_id(v);
+		outstream << "\t" << setprecision(7) << fixed << cent[v]  << endl;
+	}
+
+	outstream.close();
+	return;
+}
+
+/*
+	Write the top k nodes, one per line, tab-delimited:
+	rank, node_id, estimate, and the bounds of its confidence interval,
+	after any header lines, which should begin with #.
+	Nodes are written by their original ids
+*/
+void write_topk_outfile( string str, TopKResult &res, Graph &g, string header ) {
+
+	ofstream outstream;
+	outstream.open( str.c_str() );
+
+	outstream << header;
+	outstream << "rank\tnode\tbetweenness\tlower\tupper\n";
+
+	for(int i=0; i<res.k; i++) {
+		outstream << i+1 << "\t";
+		outstream << g.get_orig_id(res.nodes[i]);
+		outstream << "\t" << setprecision(3) << fixed
+			<< res.score[i] << "\t" << res.lower[i] << "\t" << res.upper[i] << endl;
 	}
 
 	outstream.close();
 	return;
 }
 
-/* 
+/*
+	End a run: write the results, the top k if topk is not NULL
+	and otherwise every node's centrality, print the runtimes,
+	and free centrality
+*/
+void finish_run( string outfile, float* centrality, TopKResult* topk, Graph &g, string header, uint64 btwn_ms, uint64 total_start ) {
+
+	printf("Writing output file\n");
+	if( topk != NULL ) {
+		write_topk_outfile( outfile, *topk, g, header );
+	} else {
+		write_outfile( outfile, centrality, g, header );
+	}
+	printf("Output complete\n");
+
+	uint64 total_end = getTimeMs64();
+	printf("Program complete\n");
+	printf("Betweenness Runtime: %llu ms\n", btwn_ms);
+	printf("Total runtime: %llu ms\n", total_end-total_start);
+
+	free(centrality);
+}
+
+/*
 	Return the system time in milliseconds
 */
 uint64 getTimeMs64()
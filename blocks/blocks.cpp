@@ -0,0 +1,334 @@
+/*
+	Biconnected components implementation, blocks.cpp
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Find the blocks of a graph, count the paths through its
+	articulation points, and search within the blocks, see blocks.h
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <omp.h>
+
+#include "blocks.h"
+#include "workspace.h"
+#include "radix_heap.h"
+#include "reduction.h"
+
+/*
+	The blocks found by the depth-first search.  Block b hangs
+	from top[b], the node the search entered it from, and holds
+	the nodes of which it is the first block found, numbered
+	within it from 1, top[b] being 0.  Every node but the roots
+	of the search is in exactly one such block, its own block
+*/
+struct BlockSplit {
+	int num_blocks;
+	int* top;		// per block, the node it hangs from
+	int* top_reach;		// per block, the reach of top within it
+	int* size;		// per block, its number of nodes
+	int* own_block;		// per node, its own block, -1 for roots
+	int* local_id;		// per node, its number within its own block
+	int* own_reach;		// per node, its reach within its own block
+	int* disc;		// per node, its discovery time
+};
+
+/*
+	Depth-first search each component of g, iteratively, to split
+	it into blocks.  A child w of u whose subtree reaches no higher
+	than u, low[w] >= disc[u], closes a block: the nodes discovered
+	since w, under u.  The subtree of w is then one of the parts
+	u cuts off, and the paths between the parts of every node
+	are added to centrality
+*/
+static void split_blocks(Graph &g, BlockSplit &split, float* centrality) {
+
+	int num_verts = g.get_num_verts();
+	eid_t* csr1 = g.get_csr1();
+	int* csr2 = g.get_csr2();
+
+	int* disc = split.disc;
+	int* low = new int[num_verts];
+	int* parent = new int[num_verts];
+	int* subtree = new int[num_verts];
+	eid_t* next = new eid_t[num_verts];
+	int* order = new int[num_verts];
+	int* dfs_stack = new int[num_verts];
+	int* node_stack = new int[num_verts];
+	long long* cut_sum = new long long[num_verts];
+	long long* cut_sq = new long long[num_verts];
+
+	// a graph of n nodes has fewer than n blocks
+	split.num_blocks = 0;
+	split.top = new int[num_verts];
+	split.top_reach = new int[num_verts];
+	split.size = new int[num_verts];
+	split.own_block = new int[num_verts];
+	split.local_id = new int[num_verts];
+	split.own_reach = new int[num_verts];
+
+	for(int v=0; v<num_verts; v++) {
+		disc[v] = -1;
+		split.own_block[v] = -1;
+		split.local_id[v] = 0;
+		cut_sum[v] = 0;
+		cut_sq[v] = 0;
+	}
+
+	int time = 0;
+	for(int root=0; root<num_verts; root++) {
+		if( disc[root] >= 0 ) {
+			continue;
+		}
+		int first_time = time;
+		int first_block = split.num_blocks;
+		int depth = 0;
+		int nodes = 0;
+		disc[root] = low[root] = time;
+		order[time++] = root;
+		parent[root] = -1;
+		subtree[root] = 1;
+		next[root] = csr1[root];
+		dfs_stack[depth++] = root;
+		node_stack[nodes++] = root;
+
+		while( depth > 0 ) {
+			int u = dfs_stack[depth-1];
+			if( next[u] < csr1[u+1] ) {
+				int w = csr2[next[u]++];
+				if( disc[w] < 0 ) {
+					disc[w] = low[w] = time;
+					order[time++] = w;
+					parent[w] = u;
+					subtree[w] = 1;
+					next[w] = csr1[w];
+					dfs_stack[depth++] = w;
+					node_stack[nodes++] = w;
+				} else if( disc[w] < low[u] ) {
+					low[u] = disc[w];
+				}
+				continue;
+			}
+
+			// u is finished, close its block if it has one
+			depth--;
+			int p = parent[u];
+			if( p < 0 ) {
+				continue;
+			}
+			if( low[u] < low[p] ) {
+				low[p] = low[u];
+			}
+			subtree[p] += subtree[u];
+			if( low[u] >= disc[p] ) {
+				int b = split.num_blocks++;
+				int local = 1;
+				int w;
+				do {
+					w = node_stack[--nodes];
+					split.own_block[w] = b;
+					split.local_id[w] = local++;
+				} while( w != u );
+				split.top[b] = p;
+				split.size[b] = local;
+				split.top_reach[b] = subtree[u];
+				cut_sum[p] += subtree[u];
+				cut_sq[p] += (long long)subtree[u] * subtree[u];
+			}
+		}
+
+		// the top of a block stands for all but the block's side
+		long long comp_size = subtree[root];
+		for(int b=first_block; b<split.num_blocks; b++) {
+			split.top_reach[b] = int(comp_size - split.top_reach[b]);
+		}
+		for(int i=first_time; i<time; i++) {
+			int v = order[i];
+			long long rest = comp_size - 1 - cut_sum[v];
+			double pairs = 0.5 * double( (comp_size-1)*(comp_size-1) - cut_sq[v] - rest*rest );
+			centrality[v] = float(pairs);
+			split.own_reach[v] = int(1 + cut_sum[v]);
+		}
+	}
+
+	delete [] low;
+	delete [] parent;
+	delete [] subtree;
+	delete [] next;
+	delete [] order;
+	delete [] dfs_stack;
+	delete [] node_stack;
+	delete [] cut_sum;
+	delete [] cut_sq;
+}
+
+/* the number, within block b, of node v, which lies in b */
+static inline int block_slot(BlockSplit &split, int* first, int b, int v) {
+	return first[b] + ( ( split.own_block[v] == b ) ? split.local_id[v] : 0 );
+}
+
+/*
+	The blocks of g as one graph of disjoint pieces, block b
+	numbered from first[b], a node of g once in each block
+	holding it.  An edge u, w, with u discovered first, lies in
+	the own block of w, whether w is u's child or below it.
+	The copies of a node in its blocks are its own, so each node
+	scans its edges once and fills its copies' rows without locks.
+	Sets node_of and reach of every node of the result
+*/
+static Graph* block_graph(Graph &g, BlockSplit &split, int* first, int** node_of, int** reach) {
+
+	int num_verts = g.get_num_verts();
+	eid_t* csr1 = g.get_csr1();
+	int* csr2 = g.get_csr2();
+	int* weights = g.get_weights();
+	int* disc = split.disc;
+
+	first[0] = 0;
+	for(int b=0; b<split.num_blocks; b++) {
+		first[b+1] = first[b] + split.size[b];
+	}
+	int num_nodes = first[split.num_blocks];
+
+	int* nodes = new int[num_nodes];
+	int* node_reach = new int[num_nodes];
+	for(int b=0; b<split.num_blocks; b++) {
+		nodes[first[b]] = split.top[b];
+		node_reach[first[b]] = split.top_reach[b];
+	}
+	#pragma omp parallel for
+	for(int v=0; v<num_verts; v++) {
+		int b = split.own_block[v];
+		if( b >= 0 ) {
+			nodes[first[b] + split.local_id[v]] = v;
+			node_reach[first[b] + split.local_id[v]] = split.own_reach[v];
+		}
+	}
+
+	eid_t* row_offsets = new eid_t[num_nodes+1];
+	for(int i=0; i<=num_nodes; i++) {
+		row_offsets[i] = 0;
+	}
+	#pragma omp parallel for schedule(dynamic, 64)
+	for(int u=0; u<num_verts; u++) {
+		for(eid_t j=csr1[u]; j<csr1[u+1]; j++) {
+			int w = csr2[j];
+			if( w == u ) {
+				continue;
+			}
+			int b = ( disc[u] < disc[w] ) ? split.own_block[w] : split.own_block[u];
+			row_offsets[ block_slot(split, first, b, u) + 1 ]++;
+		}
+	}
+	for(int i=0; i<num_nodes; i++) {
+		row_offsets[i+1] += row_offsets[i];
+	}
+
+	eid_t num_edges = row_offsets[num_nodes];
+	int* neighbors = new int[num_edges];
+	int* edge_weights = (weights == NULL) ? NULL : new int[num_edges];
+	eid_t* fill = new eid_t[num_nodes];
+	for(int i=0; i<num_nodes; i++) {
+		fill[i] = row_offsets[i];
+	}
+	#pragma omp parallel for schedule(dynamic, 64)
+	for(int u=0; u<num_verts; u++) {
+		for(eid_t j=csr1[u]; j<csr1[u+1]; j++) {
+			int w = csr2[j];
+			if( w == u ) {
+				continue;
+			}
+			int b = ( disc[u] < disc[w] ) ? split.own_block[w] : split.own_block[u];
+			eid_t k = fill[ block_slot(split, first, b, u) ]++;
+			neighbors[k] = block_slot(split, first, b, w);
+			if( weights != NULL ) {
+				edge_weights[k] = weights[j];
+			}
+		}
+	}
+
+	delete [] fill;
+	*node_of = nodes;
+	*reach = node_reach;
+	return new Graph(num_nodes, num_edges, row_offsets, neighbors, edge_weights, g.get_filename());
+}
+
+/*
+	Exact betweenness within the blocks of g, see blocks.h.
+	The blocks are searched with the Dijkstra engine if the exact
+	computation would use Dijkstra or delta-stepping, and otherwise
+	with the BFS engine, a Workspace per thread.
+	Returns the number of blocks
+*/
+int brandes_blocks(Graph &g, float* centrality, BrandesOptions &opts) {
+
+	int num_verts = g.get_num_verts();
+	BlockSplit split;
+	split.disc = new int[num_verts];
+	split_blocks(g, split, centrality);
+
+	int* first = new int[split.num_blocks+1];
+	int* node_of;
+	int* reach;
+	Graph* blocks = block_graph(g, split, first, &node_of, &reach);
+	int num_nodes = blocks->get_num_verts();
+
+	int largest = 0;
+	for(int b=0; b<split.num_blocks; b++) {
+		if( split.size[b] > largest ) {
+			largest = split.size[b];
+		}
+	}
+	printf("Split into %d blocks, the largest of %d vertices, %d block vertices in all\n", split.num_blocks, largest, num_nodes);
+
+	int engine = choose_engine(g, opts);
+	bool weighted = ( engine == ENGINE_DIJKSTRA || engine == ENGINE_DELTA_STEPPING );
+
+	float* block_centrality = new float[num_nodes];
+	for(int i=0; i<num_nodes; i++) {
+		block_centrality[i] = 0.0;
+	}
+	CentralityReduction red(block_centrality, num_nodes, opts.reduce_mode, opts.mem_budget_mb);
+
+	#pragma omp parallel
+	{
+		Workspace ws(num_nodes);
+		RadixHeap heap;
+		float* acc = red.thread_begin();
+		bool atomic = red.is_atomic();
+
+		// a search stays in its block, so blocks run side by side
+		#pragma omp for schedule(dynamic, 8)
+		for(int i=0; i<num_nodes; i++) {
+			if( weighted ) {
+				brandes_dijkstra_source(*blocks, ws, heap, i, acc, atomic, 0.5, false, reach, NULL);
+			} else {
+				brandes_bfs_source(*blocks, ws, i, acc, atomic, 0.5, false, opts.bfs_direction, reach, NULL);
+			}
+		}
+
+		red.thread_end();
+	}
+
+	for(int i=0; i<num_nodes; i++) {
+		centrality[node_of[i]] += block_centrality[i];
+	}
+
+	int num_blocks = split.num_blocks;
+	delete blocks;
+	delete [] first;
+	delete [] node_of;
+	delete [] reach;
+	delete [] block_centrality;
+	delete [] split.disc;
+	delete [] split.top;
+	delete [] split.top_reach;
+	delete [] split.size;
+	delete [] split.own_block;
+	delete [] split.local_id;
+	delete [] split.own_reach;
+	return num_blocks;
+}
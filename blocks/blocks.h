@@ -0,0 +1,47 @@
+/*
+	Biconnected components header, blocks.h
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Exact betweenness searched within the biconnected components,
+	or blocks, of a graph, rather than across the whole graph.
+
+	Blocks share only articulation points, and a shortest path
+	between two nodes of a block stays within it.  Seen from a
+	block B, each of its nodes v stands for reach_B(v) nodes:
+	itself, and the nodes it cuts off from B.  So a node's
+	betweenness is the sum of
+
+		within each block B holding it, the paths between the
+		nodes of B, a pair s, t weighted reach_B(s) reach_B(t),
+		counted by brandes_bfs_source or brandes_dijkstra_source,
+		see brandes.h
+
+		if it is an articulation point, whose removal splits its
+		connected component of N nodes into parts of p_1, p_2, ...
+		nodes, the paths between different parts, all through it:
+		((N-1)^2 - sum p_i^2) / 2
+
+	The blocks, their articulation points and the reaches come
+	from one depth-first search, after Hopcroft and Tarjan.  The
+	blocks are laid out as one graph of disjoint pieces, an
+	articulation point appearing once in each of its blocks, and
+	every piece is searched from each of its nodes.  A search
+	never leaves its block, so the work is the sum over blocks
+	of their nodes times their edges, rather than the nodes
+	times the edges of the graph, and the sources of all blocks
+	are handed out to the threads together, so small blocks are
+	searched in parallel with each other and the largest.
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#ifndef BLOCKS_H
+#define BLOCKS_H
+
+#include "graph.h"
+#include "brandes.h"
+
+int brandes_blocks(Graph&, float*, BrandesOptions&);
+
+#endif
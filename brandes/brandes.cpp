@@ -0,0 +1,935 @@
+/*
+	Brandes engines implementation, brandes.cpp
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Compute betweenness centrality for all nodes in a graph,
+	with the Brandes algorithm, in parallel.
+	Each source node runs a single-source shortest path,
+	then propogates dependencies back toward the source.
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#include <omp.h>
+#include <cstdio>
+#include <cstdlib>
+
+#include "brandes.h"
+#include "radix_heap.h"
+#include "workspace.h"
+#include "reduction.h"
+#include "delta_stepping.h"
+#include "approx.h"
+#include "multi_source.h"
+#include "spmm.h"
+#include "interleave.h"
+
+/*
+	Compute betweenness centrality using Brandes method,
+	with the engine chosen for the graph and options
+*/
+int brandes(Graph &g, float* centrality, BrandesOptions &opts) {
+
+	switch( choose_engine(g, opts) ) {
+		case ENGINE_DIJKSTRA:
+			return brandes_dijkstra(g, centrality, opts);
+		case ENGINE_DELTA_STEPPING:
+			return brandes_delta_stepping(g, centrality, opts);
+		case ENGINE_MULTI_SOURCE:
+			return brandes_multi_source(g, centrality, opts);
+		case ENGINE_SPMM:
+			return brandes_spmm(g, centrality, opts);
+		case ENGINE_INTERLEAVED:
+			return brandes_interleaved(g, centrality, opts);
+		default:
+			return brandes_bfs(g, centrality, opts);
+	}
+}
+
+/*
+	Resolve ENGINE_AUTO.
+	Unweighted graphs use BFS if a BFS direction or BFS stats
+	are asked for, and otherwise multi-source BFS if a
+	MultiSourceBFS per thread fits in the memory budget.
+	Weighted graphs use Dijkstra,
+	unless one Workspace per thread would exceed the memory budget,
+	in which case all threads share one delta-stepping search
+*/
+int choose_engine(Graph &g, BrandesOptions &opts) {
+	if( opts.engine != ENGINE_AUTO ) {
+		return opts.engine;
+	}
+	if( !g.is_weighted() ) {
+		if( opts.bfs_direction != BFS_AUTO || opts.bfs_stats ) {
+			return ENGINE_BFS;
+		}
+		double batch_mb = double(g.get_num_verts()) * MultiSourceBFS::bytes_per_node() / (1024.0*1024.0);
+		if( omp_get_max_threads() * batch_mb <= opts.mem_budget_mb ) {
+			return ENGINE_MULTI_SOURCE;
+		}
+		return ENGINE_BFS;
+	}
+	double workspace_mb = double(g.get_num_verts()) * (2*sizeof(int) + sizeof(sigma_t) + sizeof(float)) / (1024.0*1024.0);
+	if( omp_get_max_threads() > 1 && omp_get_max_threads() * workspace_mb > opts.mem_budget_mb ) {
+		return ENGINE_DELTA_STEPPING;
+	}
+	return ENGINE_DIJKSTRA;
+}
+
+const char* engine_name(int engine) {
+	switch( engine ) {
+		case ENGINE_BFS:
+			return "BFS (unweighted)";
+		case ENGINE_DIJKSTRA:
+			return "Dijkstra with radix heap (weighted)";
+		case ENGINE_DELTA_STEPPING:
+			return "parallel delta-stepping, one source at a time";
+		case ENGINE_MULTI_SOURCE:
+			return "bit-parallel multi-source BFS (unweighted)";
+		case ENGINE_SPMM:
+			return "batched sparse matrix products (unweighted)";
+		case ENGINE_INTERLEAVED:
+			return "interleaved BFS with prefetch (unweighted)";
+		default:
+			return "auto";
+	}
+}
+
+/* default options */
+BrandesOptions::BrandesOptions() {
+	engine = ENGINE_AUTO;
+	reduce_mode = REDUCE_AUTO;
+	mem_budget_mb = 1024;
+	bucket_width = 0;
+	ds_stats = false;
+	bfs_direction = BFS_AUTO;
+	bfs_stats = false;
+	batch_width = 0;
+	interleave_lanes = INTERLEAVE_LANES;
+	approx_epsilon = 0.0;
+	top_k = 0;
+	approx_delta = 0.1;
+	seed = 1;
+	num_sources = 0;
+	pivot_strategy = PIVOT_UNIFORM;
+	pivot_file = NULL;
+	prune = false;
+	blocks = false;
+	twins = false;
+}
+
+/*
+	A bottom-up BFS level scans every node, not only the
+	unreached ones; a scan of this many nodes is counted
+	as one edge examined when choosing a direction
+*/
+#define BFS_NODES_PER_EDGE 16
+
+/*
+	The fewest lanes, on average, that must share each read of a
+	row for a thread to keep running multi-source batches
+*/
+#define MS_MIN_SHARING 4
+
+/*
+	Add a dependency into an accumulator,
+	atomically when the accumulator is shared between threads
+*/
+static inline void add_centrality(float* centrality, int v, float value, bool atomic) {
+	if( atomic ) {
+		#pragma omp atomic
+		centrality[v] += value;
+	} else {
+		centrality[v] += value;
+	}
+}
+
+/*
+	Print the edges examined by the BFS engine against those
+	a top-down search would examine, and with per_level,
+	one line per level
+*/
+static void print_bfs_stats(BFS_level* levels, int num_levels, bool per_level) {
+
+	long long searches = 0;
+	long long bottom_up = 0;
+	long long examined = 0;
+	long long frontier_edges = 0;
+	for(int l=0; l<num_levels; l++) {
+		searches += levels[l].searches;
+		bottom_up += levels[l].bottom_up;
+		examined += levels[l].examined;
+		frontier_edges += levels[l].frontier_edges;
+	}
+
+	printf("BFS: %lld levels expanded, %lld bottom-up, at most %d levels per source\n", searches, bottom_up, num_levels);
+	printf("BFS: %lld edges examined, %lld top-down\n", examined, frontier_edges);
+
+	if( per_level ) {
+		printf("level\tsearches\tbottom-up\texamined\ttop-down\n");
+		for(int l=0; l<num_levels; l++) {
+			printf("%d\t%lld\t%lld\t%lld\t%lld\n", l, levels[l].searches, levels[l].bottom_up, levels[l].examined, levels[l].frontier_edges);
+		}
+	}
+}
+
+/*
+	Compute betweenness centrality using Brandes method
+	on an unweighted graph.
+
+	Every edge has length 1, so a breadth-first search
+	finds shortest paths without a priority queue.
+	Each thread allocates one Workspace
+	and reuses it for all of its sources.
+*/
+int brandes_bfs(Graph &g, float* centrality, BrandesOptions &opts) {
+
+	int num_verts = g.get_num_verts();
+	CentralityReduction red(centrality, num_verts, opts.reduce_mode, opts.mem_budget_mb);
+
+	// level counts of all threads
+	BFS_level* levels = NULL;
+	int num_levels = 0;
+
+	/*
+		Compute centrality for each node i.
+		Can be done in parallel
+	*/
+	#pragma omp parallel
+	{
+		Workspace ws(num_verts);
+		float* acc = red.thread_begin();
+		bool atomic = red.is_atomic();
+
+		// sources differ in cost, so hand them out dynamically
+		#pragma omp for schedule(dynamic, 8)
+		for(int i=0; i<num_verts; i++) {
+			brandes_bfs_source(g, ws, i, acc, atomic, 0.5, false, opts.bfs_direction, NULL, NULL);
+		}
+
+		red.thread_end();
+
+		#pragma omp critical
+		{
+			if( ws.get_num_levels() > num_levels ) {
+				levels = (BFS_level*)realloc( levels, ws.get_num_levels()*sizeof(BFS_level) );
+				if( levels == NULL ) {
+					printf("bad realloc of BFS levels: %d\n", ws.get_num_levels());
+					exit(1);
+				}
+				for(int l=num_levels; l<ws.get_num_levels(); l++) {
+					levels[l].searches = 0;
+					levels[l].bottom_up = 0;
+					levels[l].examined = 0;
+					levels[l].frontier_edges = 0;
+				}
+				num_levels = ws.get_num_levels();
+			}
+			BFS_level* mine = ws.get_levels();
+			for(int l=0; l<ws.get_num_levels(); l++) {
+				levels[l].searches += mine[l].searches;
+				levels[l].bottom_up += mine[l].bottom_up;
+				levels[l].examined += mine[l].examined;
+				levels[l].frontier_edges += mine[l].frontier_edges;
+			}
+		}
+	}
+
+	print_bfs_stats(levels, num_levels, opts.bfs_stats);
+	free(levels);
+
+	return 0;
+}
+
+/*
+	Expand BFS level level bottom-up: every node of component comp,
+	the source's, not yet reached
+	sums the paths of its neighbors at level, and if it has any,
+	is reached at level+1 and appended to the queue, whose tail
+	is returned; next_edges counts the edges of the nodes reached.
+
+	A node not yet reached cannot neighbor a node before level,
+	or it would already be reached, so every reached neighbor is
+	a shortest path parent.  Path counts need all of the parents,
+	so the scan of a row does not stop at the first one found;
+	bottom-up pays off where the frontier holds more edges than
+	the nodes left to reach, the late levels of a low-diameter graph.
+*/
+static int bfs_bottom_up(Graph &g, Workspace &ws, int comp, int level, int tail, long long &next_edges) {
+
+	eid_t* csr1 = g.get_csr1();
+	int* csr2 = g.get_csr2();
+	int* verts = g.get_component_verts(comp);
+	int comp_size = g.get_component_size(comp);
+
+	int* queue = ws.get_queue();
+	int* dist = ws.get_dist();
+	sigma_t* num_paths = ws.get_num_paths();
+
+	for(int i=0; i<comp_size; i++) {
+		int v = verts[i];
+		if( dist[v] >= 0 ) {
+			continue;
+		}
+		eid_t offset = csr1[v];
+		int degree = csr1[v+1] - offset;
+		sigma_t paths = 0;
+		for(int j=0; j<degree; j++) {
+			int parent = csr2[j+offset];
+			if( dist[parent] == level ) {
+				paths += num_paths[parent];
+			}
+		}
+		if( paths > 0 ) {
+			dist[v] = level + 1;
+			num_paths[v] = paths;
+			queue[tail++] = v;
+			next_edges += degree;
+		}
+	}
+	return tail;
+}
+
+/*
+	Run one source of the BFS engine, adding the
+	dependencies of source src, times scale, into centrality,
+	with atomic updates if centrality is shared.
+	Each pair is counted from both ends, so the exact
+	computation uses a scale of 1/2.  With linear, the dependency
+	of a pair is weighted by how far along the path the node lies,
+	see pivots.cpp; delta then sums 1/d(src,t) over the pairs
+	and is multiplied by the node's own distance when added.
+
+	The FIFO frontier is the workspace queue;
+	since nodes are appended in order of discovery,
+	the same array is the level-ordered stack
+	walked backwards to accumulate dependencies.
+
+	Each level is expanded top-down, pushing paths from the
+	frontier to its neighbors, or bottom-up, each unreached node
+	pulling paths from its neighbors on the frontier, see
+	bfs_bottom_up; direction, a BFSDirection, picks one, or with
+	BFS_AUTO, whichever examines fewer edges.  Only the component
+	of src can be reached, so the nodes a bottom-up level scans,
+	and the edges left to reach, are those of the component.
+
+	With reach, each node stands for reach[node] nodes of a
+	larger graph, see prune.h: a pair counts reach[src] times
+	reach[target], so a target adds reach[target] in place of 1
+	to its parents' dependencies, and the dependencies of src
+	are added reach[src] times.  reach is NULL when every node
+	stands for itself.
+
+	With twins, each node stands for twins[node] nodes with the
+	same neighbors, see twins.h: a path through a node is
+	twins[node] paths.  Once a level is final, the path count of
+	each of its nodes but src is multiplied by twins[node], so
+	num_paths holds the paths to all of a node's twins, and delta
+	its twins' dependencies together; a node adds delta over
+	twins[node], one twin's share.  A target stands for twins[target]
+	targets, and src for twins[src] sources, as with reach; the
+	pairs between src and its own twins are left to the caller.
+	twins is NULL, and linear false, when reach is given.
+	Shortest path parents are re-derived from distances
+	while walking back, so the backward pass is
+	a scan of csr2 rows rather than of parent lists.
+	The workspace must be reset on entry, and is
+	reset again, over the touched nodes only, on exit.
+*/
+void brandes_bfs_source(Graph &g, Workspace &ws, int src, float* centrality, bool atomic, float scale, bool linear, int direction, int* reach, int* twins) {
+
+	eid_t* csr1 = g.get_csr1();
+	int* csr2 = g.get_csr2();
+	int comp = g.get_component(src);
+	int comp_size = g.get_component_size(comp);
+
+	int* queue = ws.get_queue();
+	int* dist = ws.get_dist();
+	sigma_t* num_paths = ws.get_num_paths();
+	float* delta = ws.get_delta();
+
+	dist[src] = 0;
+	num_paths[src] = 1;
+	if( reach != NULL ) {
+		scale *= reach[src];
+	}
+	if( twins != NULL ) {
+		scale *= twins[src];
+	}
+
+	// the frontier is queue[head..tail)
+	int head = 0;
+	int tail = 0;
+	queue[tail++] = src;
+
+	// the edges of the frontier, and of the component's nodes not yet reached
+	long long frontier_edges = csr1[src+1] - csr1[src];
+	long long unreached_edges = (long long)g.get_component_edges(comp) - frontier_edges;
+
+	/*
+		Breadth-First Search Single-Source Shortest Path,
+		one level at a time
+	*/
+	for(int level=0; head < tail; level++) {
+
+		int level_end = tail;
+		int next_dist = level + 1;
+		long long next_edges = 0;
+
+		if( twins != NULL && level > 0 ) {
+			for(int j=head; j<level_end; j++) {
+				num_paths[queue[j]] *= twins[queue[j]];
+			}
+		}
+
+		bool bottom_up = ( direction == BFS_BOTTOM_UP )
+			|| ( direction == BFS_AUTO && frontier_edges > unreached_edges + comp_size/BFS_NODES_PER_EDGE );
+
+		if( bottom_up ) {
+			tail = bfs_bottom_up(g, ws, comp, level, tail, next_edges);
+			ws.add_level(level, true, unreached_edges, frontier_edges);
+			head = level_end;
+		} else {
+			while( head < level_end ) {
+
+				int current_node = queue[head++];
+
+				// get neighbors of current node
+				eid_t offset = csr1[current_node];
+				int degree = csr1[current_node+1] - offset;
+				int neighbor;
+
+				/*
+					For each neighbor of the current_node,
+					discover it if unseen, then add the paths
+					through current_node if it lies on a shortest path
+				*/
+				for(int j=0; j<degree; j++) {
+					neighbor = csr2[j+offset];
+					if( dist[neighbor] < 0 ) {
+						dist[neighbor] = next_dist;
+						queue[tail++] = neighbor;
+						next_edges += csr1[neighbor+1] - csr1[neighbor];
+					}
+					if( dist[neighbor] == next_dist ) {
+						num_paths[neighbor] += num_paths[current_node];
+					}
+				}
+			}
+			ws.add_level(level, false, frontier_edges, frontier_edges);
+		}
+
+		frontier_edges = next_edges;
+		unreached_edges -= next_edges;
+	}
+	ws.set_num_touched(tail);
+
+	/*
+		Propogate centrality from the last discovered nodes to src.
+		Walking the queue backwards visits nodes in
+		non-increasing distance.  No parents are stored;
+		each node instead pulls the dependency of its children,
+		the neighbors one step further from src,
+		whose deltas are already final.
+		Delta is added to the centrality.
+	*/
+	for(int j=tail-1; j>=0; j--) {
+		int node = queue[j];
+		int child_dist = dist[node] + 1;
+		eid_t offset = csr1[node];
+		int degree = csr1[node+1] - offset;
+		sigma_t node_paths = num_paths[node];
+		float sum = 0.0;
+		if( linear ) {
+			float pair = 1.0 / child_dist;
+			for(int k=0; k<degree; k++) {
+				int child = csr2[k+offset];
+				if( dist[child] == child_dist ) {
+					sum += node_paths / num_paths[child] * (pair + delta[child]);
+				}
+			}
+		} else if( reach != NULL ) {
+			for(int k=0; k<degree; k++) {
+				int child = csr2[k+offset];
+				if( dist[child] == child_dist ) {
+					sum += node_paths / num_paths[child] * (reach[child] + delta[child]);
+				}
+			}
+		} else if( twins != NULL ) {
+			for(int k=0; k<degree; k++) {
+				int child = csr2[k+offset];
+				if( dist[child] == child_dist ) {
+					sum += node_paths / num_paths[child] * twins[child] * (twins[child] + delta[child]);
+				}
+			}
+		} else {
+			for(int k=0; k<degree; k++) {
+				int child = csr2[k+offset];
+				if( dist[child] == child_dist ) {
+					sum += node_paths / num_paths[child] * (1 + delta[child]);
+				}
+			}
+		}
+		delta[node] = sum;
+		if( twins != NULL ) {
+			sum /= twins[node];
+		}
+		if (node != src ) {
+			add_centrality(centrality, node, linear ? sum*dist[node]*scale : sum*scale, atomic);
+		}
+	}
+
+	ws.reset();
+	return;
+}
+
+/*
+	Compute betweenness centrality using Brandes method
+	on a weighted graph, with Dijkstra's algorithm.
+	Each thread allocates one Workspace and one RadixHeap
+	and reuses them for all of its sources.
+*/
+int brandes_dijkstra(Graph &g, float* centrality, BrandesOptions &opts) {
+
+	int num_verts = g.get_num_verts();
+	CentralityReduction red(centrality, num_verts, opts.reduce_mode, opts.mem_budget_mb);
+
+	/*
+		Compute centrality for each node i.
+		Can be done in parallel
+	*/
+	#pragma omp parallel
+	{
+		Workspace ws(num_verts);
+		RadixHeap heap;
+		float* acc = red.thread_begin();
+		bool atomic = red.is_atomic();
+
+		#pragma omp for schedule(dynamic, 8)
+		for(int i=0; i<num_verts; i++) {
+			brandes_dijkstra_source(g, ws, heap, i, acc, atomic, 0.5, false, NULL, NULL);
+		}
+
+		red.thread_end();
+	}
+
+	return 0;
+}
+
+/*
+	Run one source of the Dijkstra engine, adding the
+	dependencies of source src, times scale, into centrality,
+	with atomic updates if centrality is shared,
+	and linear, reach and twins as in brandes_bfs_source;
+	a node's path count is multiplied by twins[node] when it is settled.
+
+	Nodes are appended to the workspace queue as they are settled,
+	in non-decreasing distance, so the queue walked backwards is
+	the stack for accumulating dependencies.
+	Weights are positive, so a node's shortest path children
+	are settled after it, and the parent re-derivation of the
+	BFS engine carries over with dist + weight in place of dist + 1.
+*/
+void brandes_dijkstra_source(Graph &g, Workspace &ws, RadixHeap &heap, int src, float* centrality, bool atomic, float scale, bool linear, int* reach, int* twins) {
+
+	eid_t* csr1 = g.get_csr1();
+	int* csr2 = g.get_csr2();
+	int* weights = g.get_weights();
+
+	int* queue = ws.get_queue();
+	int* dist = ws.get_dist();
+	sigma_t* num_paths = ws.get_num_paths();
+	float* delta = ws.get_delta();
+
+	dist[src] = 0;
+	num_paths[src] = 1;
+	if( reach != NULL ) {
+		scale *= reach[src];
+	}
+	if( twins != NULL ) {
+		scale *= twins[src];
+	}
+	heap.clear();
+	heap.push(src, 0);
+	int tail = 0;
+
+	/*
+		Dijkstra's Single-Source Shortest Path
+	*/
+	while ( !heap.is_empty() ) {
+
+		RH_elem min = heap.pop_min();
+		int current_node = min.node;
+
+		// skip stale entries, left behind when a node's distance decreased
+		if( int(min.dist) != dist[current_node] ) {
+			continue;
+		}
+		queue[tail++] = current_node;
+		if( twins != NULL && current_node != src ) {
+			num_paths[current_node] *= twins[current_node];
+		}
+
+		// get neighbors of current node
+		eid_t offset = csr1[current_node];
+		int degree = csr1[current_node+1] - offset;
+		int neighbor;
+
+		/*
+			For each neighbor of the current_node,
+			see if a new shortest path is found.
+			If so, update the distance and path count, and queue it
+		*/
+		for(int j=0; j<degree; j++) {
+			neighbor = csr2[j+offset];
+			int new_dist = min.dist + ((weights == NULL) ? 1 : weights[j+offset]);
+			if( dist[neighbor] < 0 || new_dist < dist[neighbor] ) {
+				dist[neighbor] = new_dist;
+				num_paths[neighbor] = num_paths[current_node];
+				heap.push(neighbor, new_dist);
+			} else if( new_dist == dist[neighbor] ) {
+				num_paths[neighbor] += num_paths[current_node];
+			}
+		}
+	}
+	ws.set_num_touched(tail);
+
+	/*
+		Propogate centrality from the last settled nodes to src.
+		Each node pulls the dependency of its children,
+		the neighbors whose distance is its distance plus the edge weight.
+		Delta is added to the centrality.
+	*/
+	for(int j=tail-1; j>=0; j--) {
+		int node = queue[j];
+		int node_dist = dist[node];
+		eid_t offset = csr1[node];
+		int degree = csr1[node+1] - offset;
+		sigma_t node_paths = num_paths[node];
+		float sum = 0.0;
+		for(int k=0; k<degree; k++) {
+			int child = csr2[k+offset];
+			if( dist[child] == node_dist + ((weights == NULL) ? 1 : weights[k+offset]) ) {
+				float pair = linear ? 1.0 / dist[child] : 1;
+				if( reach != NULL ) {
+					pair *= reach[child];
+				}
+				if( twins != NULL ) {
+					sum += node_paths / num_paths[child] * twins[child] * (twins[child] + delta[child]);
+				} else {
+					sum += node_paths / num_paths[child] * (pair + delta[child]);
+				}
+			}
+		}
+		delta[node] = sum;
+		if( twins != NULL ) {
+			sum /= twins[node];
+		}
+		if (node != src ) {
+			add_centrality(centrality, node, linear ? sum*dist[node]*scale : sum*scale, atomic);
+		}
+	}
+
+	ws.reset();
+	return;
+}
+
+/*
+	Compute betweenness centrality using Brandes method,
+	one source at a time, with all threads on each source.
+
+	Distances come from a parallel delta-stepping search.
+	Path counts and dependencies are then computed in groups of
+	reached nodes, in distance order.  A group spans less than
+	the smallest edge weight, so no node in a group can be the
+	shortest path parent of another, and the nodes of a group
+	are processed in parallel, each pulling from its neighbors.
+	Each node is written by one thread, so no reduction is needed.
+*/
+int brandes_delta_stepping(Graph &g, float* centrality, BrandesOptions &opts) {
+
+	eid_t* csr1 = g.get_csr1();
+	int* csr2 = g.get_csr2();
+	int* weights = g.get_weights();
+	int num_verts = g.get_num_verts();
+
+	DeltaStepping ds(g, opts.bucket_width);
+	int* dist = ds.get_dist();
+	int min_weight = ds.get_min_weight();
+
+	sigma_t* num_paths = new sigma_t[num_verts];
+	float* delta = new float[num_verts];
+	int* group_start = new int[num_verts+1];
+	for(int i=0; i<num_verts; i++) {
+		num_paths[i] = 0;
+		delta[i] = 0.0;
+	}
+
+	for(int src=0; src<num_verts; src++) {
+
+		ds.run(src);
+		ds.sort_by_distance();
+		int* order = ds.get_reached();
+		int num_reached = ds.get_num_reached();
+
+		// split the distance order into groups narrower than min_weight
+		int num_groups = 0;
+		for(int i=0; i<num_reached; i++) {
+			if( i == 0 || dist[order[i]] >= dist[order[group_start[num_groups-1]]] + min_weight ) {
+				group_start[num_groups++] = i;
+			}
+		}
+		group_start[num_groups] = num_reached;
+
+		num_paths[src] = 1;
+
+		#pragma omp parallel
+		{
+			/*
+				Path counts, nearest group first.
+				The source is alone in group 0
+			*/
+			for(int k=1; k<num_groups; k++) {
+				#pragma omp for schedule(dynamic, 64)
+				for(int i=group_start[k]; i<group_start[k+1]; i++) {
+					int node = order[i];
+					eid_t offset = csr1[node];
+					int degree = csr1[node+1] - offset;
+					sigma_t paths = 0;
+					for(int j=0; j<degree; j++) {
+						int parent = csr2[j+offset];
+						int w = (weights == NULL) ? 1 : weights[j+offset];
+						if( dist[parent] != DS_UNREACHED && dist[parent] + w == dist[node] ) {
+							paths += num_paths[parent];
+						}
+					}
+					num_paths[node] = paths;
+				}
+			}
+
+			/*
+				Dependencies, farthest group first.
+				Delta is added to the centrality
+			*/
+			for(int k=num_groups-1; k>=0; k--) {
+				#pragma omp for schedule(dynamic, 64)
+				for(int i=group_start[k]; i<group_start[k+1]; i++) {
+					int node = order[i];
+					int node_dist = dist[node];
+					eid_t offset = csr1[node];
+					int degree = csr1[node+1] - offset;
+					sigma_t node_paths = num_paths[node];
+					float sum = 0.0;
+					for(int j=0; j<degree; j++) {
+						int child = csr2[j+offset];
+						int w = (weights == NULL) ? 1 : weights[j+offset];
+						if( dist[child] == node_dist + w ) {
+							sum += node_paths / num_paths[child] * (1 + delta[child]);
+						}
+					}
+					delta[node] = sum;
+					if( node != src ) {
+						centrality[node] += sum/2.0;
+					}
+				}
+			}
+
+			// reset the reached nodes for the next source
+			#pragma omp for
+			for(int i=0; i<num_reached; i++) {
+				num_paths[order[i]] = 0;
+				delta[order[i]] = 0.0;
+			}
+		}
+
+		ds.reset();
+	}
+
+	ds.print_stats(opts.ds_stats);
+
+	delete [] num_paths;
+	delete [] delta;
+	delete [] group_start;
+
+	return 0;
+}
+
+/*
+	Compute betweenness centrality using Brandes method
+	on an unweighted graph, MS_LANES sources at a time.
+	Each thread allocates one MultiSourceBFS and runs
+	batches of consecutive sources with it.
+
+	A batch pays off when its lanes reach nodes on the same
+	levels, so one read of a row serves many of them, as in
+	low-diameter graphs.  On a graph of long paths, such as a
+	grid or a road network, the lanes drift apart; a thread
+	whose batches share each read among fewer than
+	MS_MIN_SHARING lanes runs its remaining sources one at a
+	time with the BFS engine
+*/
+int brandes_multi_source(Graph &g, float* centrality, BrandesOptions &opts) {
+
+	int num_verts = g.get_num_verts();
+	int num_batches = (num_verts + MS_LANES - 1) / MS_LANES;
+	CentralityReduction red(centrality, num_verts, opts.reduce_mode, opts.mem_budget_mb);
+	long long edges_read = 0;
+	long long edges_traversed = 0;
+	int single_batches = 0;
+
+	#pragma omp parallel
+	{
+		MultiSourceBFS ms(g);
+		Workspace* ws = NULL;
+		float* acc = red.thread_begin();
+		bool atomic = red.is_atomic();
+		int sources[MS_LANES];
+		int singles = 0;
+
+		#pragma omp for schedule(dynamic, 1)
+		for(int b=0; b<num_batches; b++) {
+			int first = b*MS_LANES;
+			int num_sources = (num_verts - first < MS_LANES) ? num_verts - first : MS_LANES;
+			if( ws != NULL ) {
+				for(int i=first; i<first+num_sources; i++) {
+					brandes_bfs_source(g, *ws, i, acc, atomic, 0.5, false, opts.bfs_direction, NULL, NULL);
+				}
+				singles++;
+				continue;
+			}
+			for(int i=0; i<num_sources; i++) {
+				sources[i] = first + i;
+			}
+			ms.run(sources, num_sources, acc, atomic, 0.5);
+			if( ms.get_edges_traversed() < MS_MIN_SHARING * ms.get_edges_read() ) {
+				ws = new Workspace(num_verts);
+			}
+		}
+
+		red.thread_end();
+		delete ws;
+
+		#pragma omp critical
+		{
+			edges_read += ms.get_edges_read();
+			edges_traversed += ms.get_edges_traversed();
+			single_batches += singles;
+		}
+	}
+
+	printf("Multi-source BFS: %d batches of up to %d sources, %d of them one source at a time\n",
+		num_batches, MS_LANES, single_batches);
+	printf("Multi-source BFS: %lld edges read for %lld edge traversals, %.1f per read\n",
+		edges_read, edges_traversed, (edges_read > 0) ? double(edges_traversed) / edges_read : 0.0);
+
+	return 0;
+}
+
+/*
+	Compute betweenness centrality using Brandes method
+	on an unweighted graph, a batch of sources at a time,
+	as products of the adjacency matrix with dense matrices.
+	Each thread allocates one SpMMBrandes and runs
+	batches of consecutive sources with it
+*/
+int brandes_spmm(Graph &g, float* centrality, BrandesOptions &opts) {
+
+	int num_verts = g.get_num_verts();
+	int width = opts.batch_width;
+	if( width < 1 ) {
+		// the widest, narrowed until a batch per thread fits the memory budget
+		width = SPMM_MAX_WIDTH;
+		while( width > 1 && omp_get_max_threads() * double(num_verts) * SpMMBrandes::bytes_per_node(width)
+				> opts.mem_budget_mb * 1024.0 * 1024.0 ) {
+			width /= 2;
+		}
+	}
+	int num_batches = (num_verts + width - 1) / width;
+	CentralityReduction red(centrality, num_verts, opts.reduce_mode, opts.mem_budget_mb);
+	long long row_adds = 0;
+
+	#pragma omp parallel
+	{
+		SpMMBrandes spmm(g, width);
+		float* acc = red.thread_begin();
+		bool atomic = red.is_atomic();
+		int* sources = new int[width];
+
+		#pragma omp for schedule(dynamic, 1)
+		for(int b=0; b<num_batches; b++) {
+			int first = b*width;
+			int num_sources = (num_verts - first < width) ? num_verts - first : width;
+			for(int i=0; i<num_sources; i++) {
+				sources[i] = first + i;
+			}
+			spmm.run(sources, num_sources, acc, atomic, 0.5);
+		}
+
+		red.thread_end();
+		delete [] sources;
+
+		#pragma omp atomic
+		row_adds += spmm.get_row_adds();
+	}
+
+	printf("SpMM: %d batches of width %d, %lld dense rows of %d added\n", num_batches, width, row_adds, width);
+
+	return 0;
+}
+
+/*
+	Sources handed to a thread at once by the interleaved engine,
+	per lane, so lanes are refilled within a batch
+	and sit idle only at its end
+*/
+#define INTERLEAVE_BATCH 16
+
+/*
+	Compute betweenness centrality using Brandes method
+	on an unweighted graph, each thread keeping
+	opts.interleave_lanes searches in flight and prefetching
+	ahead of each, to overlap their cache misses.
+	Each thread allocates one InterleavedBFS, a Workspace
+	per lane, and runs batches of consecutive sources with it
+*/
+int brandes_interleaved(Graph &g, float* centrality, BrandesOptions &opts) {
+
+	int num_verts = g.get_num_verts();
+	int width = opts.interleave_lanes * INTERLEAVE_BATCH;
+	int num_batches = (num_verts + width - 1) / width;
+	CentralityReduction red(centrality, num_verts, opts.reduce_mode, opts.mem_budget_mb);
+	long long nodes_expanded = 0;
+	long long edges_examined = 0;
+
+	#pragma omp parallel
+	{
+		InterleavedBFS ib(g, opts.interleave_lanes, true);
+		float* acc = red.thread_begin();
+		bool atomic = red.is_atomic();
+		int* sources = new int[width];
+
+		#pragma omp for schedule(dynamic, 1)
+		for(int b=0; b<num_batches; b++) {
+			int first = b*width;
+			int num_sources = (num_verts - first < width) ? num_verts - first : width;
+			for(int i=0; i<num_sources; i++) {
+				sources[i] = first + i;
+			}
+			ib.run(sources, num_sources, acc, atomic, 0.5);
+		}
+
+		red.thread_end();
+		delete [] sources;
+
+		#pragma omp critical
+		{
+			nodes_expanded += ib.get_nodes_expanded();
+			edges_examined += ib.get_edges_examined();
+		}
+	}
+
+	printf("Interleaved: %d lanes per thread, %lld nodes stepped, %lld edges examined\n", opts.interleave_lanes, nodes_expanded, edges_examined);
+
+	return 0;
+}
@@ -0,0 +1,122 @@
+/*
+	Brandes engines header, brandes.h
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Betweenness centrality with the Brandes algorithm.
+
+	brandes() selects an engine for the graph:
+		brandes_bfs - unweighted graphs, a breadth-first search
+			with a FIFO frontier per source, expanding each level
+			top-down or bottom-up, whichever examines fewer edges
+		brandes_dijkstra - weighted graphs, Dijkstra's algorithm
+			with a RadixHeap per thread
+		brandes_delta_stepping - weighted graphs too large for
+			a Workspace per thread; one source at a time,
+			searched by all threads with delta-stepping
+		brandes_multi_source - unweighted graphs, in batches of
+			MS_LANES sources searched together with bitsets,
+			see multi_source.h, when a MultiSourceBFS
+			per thread fits in the memory budget
+		brandes_spmm - unweighted graphs, in batches of sources,
+			as sparse matrix times dense matrix products,
+			see spmm.h; chosen only by name
+		brandes_interleaved - unweighted graphs, each thread
+			stepping several sources in turn with prefetches,
+			see interleave.h; chosen only by name
+
+	Each thread allocates one Workspace for its sources;
+	brandes_bfs_source and brandes_dijkstra_source run
+	a single source against a Workspace.
+
+	Centrality is accumulated into a caller-allocated array
+	of num_verts floats, which should be zeroed.
+	Threads combine their contributions through a
+	CentralityReduction, see reduction.h
+
+	This software is distributed under 
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#ifndef BRANDES_H
+#define BRANDES_H
+
+#include "graph.h"
+#include "workspace.h"
+#include "radix_heap.h"
+
+enum Engine {
+	ENGINE_AUTO,
+	ENGINE_BFS,
+	ENGINE_DIJKSTRA,
+	ENGINE_DELTA_STEPPING,
+	ENGINE_MULTI_SOURCE,
+	ENGINE_SPMM,
+	ENGINE_INTERLEAVED
+};
+
+/* how the BFS engine expands a level */
+enum BFSDirection {
+	BFS_AUTO,
+	BFS_TOP_DOWN,
+	BFS_BOTTOM_UP
+};
+
+/*
+	Run-time options shared by the engines
+		engine - an Engine, ENGINE_AUTO chooses by graph and memory
+		reduce_mode - a ReduceMode, how threads combine centrality
+		mem_budget_mb - memory allowed for per-thread arrays
+		bucket_width - delta-stepping bucket width, 0 for the default
+		ds_stats - print delta-stepping counts for every phase
+		bfs_direction - a BFSDirection, BFS_AUTO switches per level
+		bfs_stats - print BFS edge counts for every level
+		batch_width - sources per SpMM batch, 0 for SPMM_MAX_WIDTH
+		interleave_lanes - sources in flight per interleaved thread
+		approx_epsilon - approximate with this error bound, 0 for exact
+		top_k - find only the top k nodes, 0 for all
+		approx_delta - probability the approximation misses the bound
+		seed - random seed for sampling
+		num_sources - pivot sources to estimate from, 0 for all
+		pivot_strategy - a PivotStrategy, how pivots are chosen
+		pivot_file - file of pivot node ids, for PIVOT_FILE
+		prune - fold pendant trees into their roots, see prune.h
+		blocks - search within biconnected components, see blocks.h
+		twins - search structural twins once, see twins.h
+*/
+struct BrandesOptions {
+	int engine;
+	int reduce_mode;
+	long mem_budget_mb;
+	int bucket_width;
+	bool ds_stats;
+	int bfs_direction;
+	bool bfs_stats;
+	int batch_width;
+	int interleave_lanes;
+	double approx_epsilon;
+	int top_k;
+	double approx_delta;
+	unsigned long long seed;
+	int num_sources;
+	int pivot_strategy;
+	const char* pivot_file;
+	bool prune;
+	bool blocks;
+	bool twins;
+
+	BrandesOptions();
+};
+
+int brandes(Graph&, float*, BrandesOptions&);
+int choose_engine(Graph&, BrandesOptions&);
+const char* engine_name(int);
+int brandes_bfs(Graph&, float*, BrandesOptions&);
+void brandes_bfs_source(Graph&, Workspace&, int, float*, bool, float, bool, int, int*, int*);
+int brandes_dijkstra(Graph&, float*, BrandesOptions&);
+void brandes_dijkstra_source(Graph&, Workspace&, RadixHeap&, int, float*, bool, float, bool, int*, int*);
+int brandes_delta_stepping(Graph&, float*, BrandesOptions&);
+int brandes_multi_source(Graph&, float*, BrandesOptions&);
+int brandes_spmm(Graph&, float*, BrandesOptions&);
+int brandes_interleaved(Graph&, float*, BrandesOptions&);
+
+#endif
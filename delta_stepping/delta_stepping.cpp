@@ -0,0 +1,415 @@
+/*
+	Parallel delta-stepping implementation, delta_stepping.cpp
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Single-source shortest paths with all threads,
+	see delta_stepping.h
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#include <stdio.h>
+#include <cstdlib>
+#include <omp.h>
+
+#include "delta_stepping.h"
+
+/* a reached node and its distance, for sorting */
+struct DS_elem {
+	int dist;
+	int node;
+};
+
+static int compare_ds_elem(const void* a, const void* b) {
+	const DS_elem* x = (const DS_elem*)a;
+	const DS_elem* y = (const DS_elem*)b;
+	if( x->dist != y->dist ) return (x->dist < y->dist) ? -1 : 1;
+	return (x->node < y->node) ? -1 : (x->node > y->node);
+}
+
+/*
+	Lower *addr to val if val is smaller.
+	Returns the value *addr held before a successful update,
+	or -1 if *addr was already no larger than val
+*/
+static inline int atomic_lower(int* addr, int val) {
+	int old = *((volatile int*)addr);
+	while( val < old ) {
+		if( __sync_bool_compare_and_swap(addr, old, val) ) {
+			return old;
+		}
+		old = *((volatile int*)addr);
+	}
+	return -1;
+}
+
+DeltaStepping::DeltaStepping(Graph &g, int bucket_width) {
+	num_verts = g.get_num_verts();
+	csr1 = g.get_csr1();
+	csr2 = g.get_csr2();
+	weights = g.get_weights();
+	delta = bucket_width;
+	if( delta < 1 ) {
+		delta = default_delta(g);
+	}
+
+	min_weight = 1;
+	if( weights != NULL && g.get_num_dir_edges() > 0 ) {
+		eid_t num_edges = g.get_num_dir_edges();
+		min_weight = weights[0];
+		for(eid_t i=1; i<num_edges; i++) {
+			if( weights[i] < min_weight ) min_weight = weights[i];
+		}
+	}
+
+	dist = new int[num_verts];
+	reached = new int[num_verts];
+	sort_keys = new int[num_verts];
+	for(int i=0; i<num_verts; i++) {
+		dist[i] = DS_UNREACHED;
+	}
+	num_reached = 0;
+
+	// every successful relaxation may add a node to a frontier
+	frontier_capacity = g.get_num_dir_edges()+1;
+	frontier = new int[frontier_capacity];
+	frontier_size = 0;
+
+	num_threads = omp_get_max_threads();
+	bins = new DynamicArray**[num_threads];
+	num_bins = new int[num_threads];
+	for(int t=0; t<num_threads; t++) {
+		bins[t] = NULL;
+		num_bins[t] = 0;
+	}
+
+	stats_capacity = 16;
+	stats = (DS_phase*)calloc( stats_capacity, sizeof(DS_phase) );
+	num_stats = 0;
+	num_runs = 0;
+}
+
+DeltaStepping::~DeltaStepping() {
+	delete [] dist;
+	delete [] reached;
+	delete [] sort_keys;
+	delete [] frontier;
+	for(int t=0; t<num_threads; t++) {
+		for(int b=0; b<num_bins[t]; b++) {
+			delete bins[t][b];
+		}
+		free(bins[t]);
+	}
+	delete [] bins;
+	delete [] num_bins;
+	free(stats);
+}
+
+/*
+	The default bucket width, the mean edge weight,
+	so a typical edge lands one bin ahead
+*/
+int DeltaStepping::default_delta(Graph &g) {
+	int* w = g.get_weights();
+	eid_t num_edges = g.get_num_dir_edges();
+	if( w == NULL || num_edges == 0 ) {
+		return 1;
+	}
+	double sum = 0.0;
+	for(eid_t i=0; i<num_edges; i++) {
+		sum += w[i];
+	}
+	int mean = int(sum/num_edges + 0.5);
+	return (mean < 1) ? 1 : mean;
+}
+
+int DeltaStepping::bin_of(int d) {
+	return d / delta;
+}
+
+/* make sure thread t has a bin with index b */
+void DeltaStepping::grow_bins(int t, int b) {
+	if( b < num_bins[t] ) {
+		return;
+	}
+	int new_num = (num_bins[t] == 0) ? 64 : num_bins[t];
+	while( new_num <= b ) {
+		new_num *= 2;
+	}
+	bins[t] = (DynamicArray**)realloc( bins[t], new_num*sizeof(DynamicArray*) );
+	if( bins[t] == NULL ) {
+		printf("bad DeltaStepping realloc of bins: %d\n", new_num);
+		exit(1);
+	}
+	for(int i=num_bins[t]; i<new_num; i++) {
+		bins[t][i] = new DynamicArray();
+	}
+	num_bins[t] = new_num;
+}
+
+/* make sure there is a stats entry for phase p */
+void DeltaStepping::grow_stats(int p) {
+	while( p >= stats_capacity ) {
+		stats = (DS_phase*)realloc( stats, 2*stats_capacity*sizeof(DS_phase) );
+		if( stats == NULL ) {
+			printf("bad DeltaStepping realloc of stats\n");
+			exit(1);
+		}
+		for(int i=stats_capacity; i<2*stats_capacity; i++) {
+			stats[i].frontier = 0;
+			stats[i].relaxations = 0;
+			stats[i].updates = 0;
+		}
+		stats_capacity *= 2;
+	}
+	if( p >= num_stats ) {
+		num_stats = p+1;
+	}
+}
+
+/*
+	Compute distances from src with all threads.
+	dist must be reset, see reset()
+*/
+void DeltaStepping::run(int src) {
+
+	int curr_bin = 0;
+	int next_bin = INT_MAX;
+	int phase = 0;
+
+	dist[src] = 0;
+	reached[0] = src;
+	num_reached = 1;
+	frontier[0] = src;
+	frontier_size = 1;
+	num_runs++;
+
+	#pragma omp parallel
+	{
+		int tid = omp_get_thread_num();
+
+		while( frontier_size > 0 ) {
+
+			long long relaxations = 0;
+			long long updates = 0;
+
+			/*
+				Relax every edge of the frontier.
+				Skip nodes whose distance has since dropped
+				below this bin; they were handled in an earlier phase
+			*/
+			#pragma omp for nowait schedule(dynamic, 64)
+			for(eid_t i=0; i<frontier_size; i++) {
+				int u = frontier[i];
+				int du = dist[u];
+				if( bin_of(du) < curr_bin ) {
+					continue;
+				}
+				eid_t offset = csr1[u];
+				int degree = csr1[u+1] - offset;
+				for(int j=0; j<degree; j++) {
+					int v = csr2[j+offset];
+					int w = (weights == NULL) ? 1 : weights[j+offset];
+					int new_dist = du + w;
+					relaxations++;
+					int old = atomic_lower( &dist[v], new_dist );
+					if( old >= 0 ) {
+						updates++;
+						if( old == DS_UNREACHED ) {
+							int pos;
+							#pragma omp atomic capture
+							pos = num_reached++;
+							reached[pos] = v;
+						}
+						int b = bin_of(new_dist);
+						grow_bins(tid, b);
+						(*bins[tid][b]).push_back(v);
+					}
+				}
+			}
+
+			// the lowest non-empty bin of this thread
+			int my_next = INT_MAX;
+			for(int b=curr_bin; b<num_bins[tid]; b++) {
+				if( (*bins[tid][b]).get_size() > 0 ) {
+					my_next = b;
+					break;
+				}
+			}
+
+			#pragma omp critical
+			{
+				if( my_next < next_bin ) next_bin = my_next;
+				grow_stats(phase);
+				stats[phase].relaxations += relaxations;
+				stats[phase].updates += updates;
+			}
+			#pragma omp barrier
+
+			#pragma omp single
+			{
+				stats[phase].frontier += frontier_size;
+				phase++;
+				curr_bin = next_bin;
+				next_bin = INT_MAX;
+				frontier_size = 0;
+			}
+
+			/*
+				Gather the next frontier from every thread's bin:
+				claim a range of the frontier, grow the frontier
+				if a bin holds more re-lowered nodes than it fits,
+				then copy
+			*/
+			DynamicArray* bin = NULL;
+			int count = 0;
+			eid_t pos = 0;
+			if( curr_bin < num_bins[tid] ) {
+				bin = bins[tid][curr_bin];
+				count = (*bin).get_size();
+			}
+			if( count > 0 ) {
+				#pragma omp atomic capture
+				{ pos = frontier_size; frontier_size += count; }
+			}
+			#pragma omp barrier
+
+			#pragma omp single
+			{
+				if( frontier_size > frontier_capacity ) {
+					delete [] frontier;
+					frontier_capacity = 2*frontier_size;
+					frontier = new int[frontier_capacity];
+				}
+			}
+
+			for(int i=0; i<count; i++) {
+				frontier[pos+i] = (*bin).at(i);
+			}
+			if( count > 0 ) {
+				(*bin).clear();
+			}
+			#pragma omp barrier
+		}
+	}
+}
+
+/*
+	Order reached by non-decreasing distance.
+	Nodes are counted into bins, then each bin is sorted,
+	with the bins split across threads
+*/
+void DeltaStepping::sort_by_distance() {
+
+	int max_dist = 0;
+	#pragma omp parallel for reduction(max:max_dist)
+	for(int i=0; i<num_reached; i++) {
+		if( dist[reached[i]] > max_dist ) max_dist = dist[reached[i]];
+	}
+
+	int last_bin = bin_of(max_dist);
+	int* offsets = new int[last_bin+1];
+	DS_elem* elems = new DS_elem[num_reached];
+	for(int b=0; b<=last_bin; b++) {
+		offsets[b] = 0;
+	}
+
+	#pragma omp parallel for
+	for(int i=0; i<num_reached; i++) {
+		sort_keys[i] = bin_of( dist[reached[i]] );
+		#pragma omp atomic
+		offsets[sort_keys[i]]++;
+	}
+
+	// exclusive prefix sum, the start of each bin
+	int start = 0;
+	for(int b=0; b<=last_bin; b++) {
+		int count = offsets[b];
+		offsets[b] = start;
+		start += count;
+	}
+
+	// scatter; each bin's offset advances to the start of the next bin
+	#pragma omp parallel for
+	for(int i=0; i<num_reached; i++) {
+		int pos;
+		#pragma omp atomic capture
+		pos = offsets[sort_keys[i]]++;
+		elems[pos].dist = dist[reached[i]];
+		elems[pos].node = reached[i];
+	}
+
+	#pragma omp parallel for schedule(dynamic, 16)
+	for(int b=0; b<=last_bin; b++) {
+		int begin = (b == 0) ? 0 : offsets[b-1];
+		int count = offsets[b] - begin;
+		if( count > 1 ) {
+			qsort( elems+begin, count, sizeof(DS_elem), compare_ds_elem );
+		}
+	}
+
+	#pragma omp parallel for
+	for(int i=0; i<num_reached; i++) {
+		reached[i] = elems[i].node;
+	}
+
+	delete [] offsets;
+	delete [] elems;
+}
+
+/* restore the distance of every node reached by the last run */
+void DeltaStepping::reset() {
+	#pragma omp parallel for
+	for(int i=0; i<num_reached; i++) {
+		dist[reached[i]] = DS_UNREACHED;
+	}
+	num_reached = 0;
+}
+
+int* DeltaStepping::get_dist() {
+	return dist;
+}
+
+int* DeltaStepping::get_reached() {
+	return reached;
+}
+
+int DeltaStepping::get_num_reached() {
+	return num_reached;
+}
+
+int DeltaStepping::get_delta() {
+	return delta;
+}
+
+/* the smallest edge weight, 1 for an unweighted graph */
+int DeltaStepping::get_min_weight() {
+	return min_weight;
+}
+
+/*
+	Print relaxation counts summed over all runs,
+	and with per_phase, one line per phase number
+*/
+void DeltaStepping::print_stats(bool per_phase) {
+
+	long long frontier_total = 0;
+	long long relaxations = 0;
+	long long updates = 0;
+	for(int p=0; p<num_stats; p++) {
+		frontier_total += stats[p].frontier;
+		relaxations += stats[p].relaxations;
+		updates += stats[p].updates;
+	}
+
+	printf("Delta-stepping: delta %d, %d sources, at most %d phases per source\n", delta, num_runs, num_stats);
+	printf("Delta-stepping: %lld nodes processed, %lld edges relaxed, %lld distances lowered\n", frontier_total, relaxations, updates);
+
+	if( per_phase ) {
+		printf("phase\tfrontier\trelaxations\tupdates\n");
+		for(int p=0; p<num_stats; p++) {
+			printf("%d\t%lld\t%lld\t%lld\n", p, stats[p].frontier, stats[p].relaxations, stats[p].updates);
+		}
+	}
+}
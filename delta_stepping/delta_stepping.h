@@ -0,0 +1,114 @@
+/*
+	Parallel delta-stepping header, delta_stepping.h
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Single-source shortest paths on a weighted graph,
+	with all threads working on the one source.
+
+	Delta-stepping keeps nodes in buckets, or bins, of
+	distance width delta: bin b holds nodes with tentative
+	distance in [b*delta, (b+1)*delta).  Each phase, the threads
+	split the frontier, the nodes of the lowest non-empty bin,
+	and relax all of their edges, lowering distances with
+	compare-and-swap.  A node whose distance is lowered is pushed
+	into a thread-local bin, and the next frontier is gathered
+	from the lowest non-empty bin of all threads.
+	A small delta does little wasted work but needs many phases;
+	a large delta needs few phases but re-relaxes more edges.
+
+	Unlike the per-source engines, all state here is shared by
+	the threads, so memory is one set of num_verts arrays
+	and a frontier of num_edges entries, independent of the
+	number of threads.
+
+	After run(), sort_by_distance() lists the reached nodes
+	in non-decreasing distance, for the Brandes sweeps.
+
+	Members:
+
+		dist - tentative, then final, distance from the source,
+		DS_UNREACHED if not reached
+
+		reached - every node reached by the last run, unordered
+		until sort_by_distance()
+
+		frontier - the nodes of the current bin
+
+		bins - per thread, a DynamicArray for each bin
+
+		phase stats - per phase number, the frontier size,
+		edges relaxed, and distances lowered, summed over sources
+
+	This software is distributed under 
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#ifndef DELTA_STEPPING_H
+#define DELTA_STEPPING_H
+
+#include <limits.h>
+
+#include "graph.h"
+#include "dynamic_array.h"
+
+#define DS_UNREACHED INT_MAX
+
+struct DS_phase {
+	long long frontier;
+	long long relaxations;
+	long long updates;
+};
+
+class DeltaStepping {
+
+	public:
+		DeltaStepping(Graph&, int);
+		~DeltaStepping();
+
+		void run(int);
+		void sort_by_distance();
+		void reset();
+
+		int* get_dist();
+		int* get_reached();
+		int get_num_reached();
+		int get_delta();
+		int get_min_weight();
+
+		void print_stats(bool);
+
+		static int default_delta(Graph&);
+
+	private:
+		int bin_of(int);
+		void grow_bins(int, int);
+		void grow_stats(int);
+
+		int num_verts;
+		eid_t* csr1;
+		int* csr2;
+		int* weights;
+		int delta;
+		int min_weight;
+
+		int* dist;
+		int* reached;
+		int num_reached;
+		int* sort_keys;
+
+		int* frontier;
+		eid_t frontier_size;
+		eid_t frontier_capacity;
+
+		int num_threads;
+		DynamicArray*** bins;
+		int* num_bins;
+
+		DS_phase* stats;
+		int num_stats;
+		int stats_capacity;
+		int num_runs;
+
+};
+
+#endif
@@ -53,6 +53,15 @@ void DynamicArray::push_back(int v) {
 	return;
 }
 
+/*
+	Remove all elements,
+	keeping the capacity for reuse
+*/
+void DynamicArray::clear() {
+	size=0;
+	return;
+}
+
 void DynamicArray::expand() {
 
 	capacity*=2;
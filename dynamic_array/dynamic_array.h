@@ -23,6 +23,7 @@ class DynamicArray {
 		DynamicArray();
 		~DynamicArray();
 		void push_back(int);
+		void clear();
 		void expand();
 		void print_capacity();
 		void print_size();
@@ -0,0 +1,186 @@
+/*
+	Adjacency list reader implementation, adjlist_reader.cpp
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Parses an adjacency list in parallel, directly into CSR,
+	see graph_reader.h
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#include<cstdio>
+#include<cstdlib>
+#include<climits>
+#include<omp.h>
+
+#include "graph_reader.h"
+
+static inline bool is_space(char c) {
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+int AdjlistReader::get_format() {
+	return FORMAT_ADJLIST;
+}
+
+/*
+	Count the rows and neighbor tokens of a chunk,
+	and whether any neighbor carries a weight
+*/
+static void count_chunk(ParseChunk &chunk) {
+	long long rows = 0;
+	long long neighbors = 0;
+	bool weighted = false;
+	const char* p = chunk.begin;
+	while( p < chunk.end ) {
+		// one row: the vertex id, then its neighbors
+		int tokens = 0;
+		while( p < chunk.end && *p != '\n' ) {
+			while( p < chunk.end && is_space(*p) ) p++;
+			if( p == chunk.end || *p == '\n' ) break;
+			tokens++;
+			while( p < chunk.end && !is_space(*p) && *p != '\n' ) {
+				if( *p == ':' ) weighted = true;
+				p++;
+			}
+		}
+		if( tokens > 1 ) {
+			neighbors += tokens - 1;
+		}
+		rows++;
+		p++;
+	}
+	chunk.num_lines = rows;
+	chunk.num_items = neighbors;
+	chunk.weighted = weighted;
+}
+
+/*
+	Parse the neighbors of a chunk's rows into csr2 and weights,
+	and the end of each row into csr1.
+	Integers are parsed by hand, with no copy of the token.
+	Returns false on a malformed token or a neighbor out of range
+*/
+static bool parse_chunk(ParseChunk &chunk, CSRArrays &g, string infile) {
+
+	const char* p = chunk.begin;
+	const char* end = chunk.end;
+	int row = chunk.first_line;
+	eid_t edge = chunk.first_item;
+	while( p < end ) {
+		bool first = true;
+		while( p < end && *p != '\n' ) {
+			while( p < end && is_space(*p) ) p++;
+			if( p == end || *p == '\n' ) break;
+
+			long long vert = 0;
+			const char* token = p;
+			while( p < end && *p >= '0' && *p <= '9' ) {
+				if( vert <= INT_MAX ) vert = vert*10 + (*p - '0');
+				p++;
+			}
+			if( p == token || vert >= g.num_verts ) {
+				return false;
+			}
+			long long weight = 1;
+			if( p < end && *p == ':' ) {
+				p++;
+				const char* digits = p;
+				weight = 0;
+				while( p < end && *p >= '0' && *p <= '9' ) {
+					if( weight <= INT_MAX ) weight = weight*10 + (*p - '0');
+					p++;
+				}
+				if( p == digits || weight < 1 || weight > INT_MAX ) {
+					printf("bad edge weight in %s: %.*s\n", infile.c_str(), int(p-token), token);
+					return false;
+				}
+			}
+			if( p < end && !is_space(*p) && *p != '\n' ) {
+				return false;
+			}
+
+			// the first token is the row's own vertex id
+			if( first ) {
+				first = false;
+				continue;
+			}
+			g.csr2[edge] = vert;
+			if( g.weights != NULL ) {
+				g.weights[edge] = weight;
+			}
+			edge++;
+		}
+		g.csr1[++row] = edge;
+		p++;
+	}
+	return true;
+}
+
+/*
+	Load a graph from an adjacency list file.
+
+	The file is mapped and split into chunks at line starts.
+	A first parallel pass counts the rows and neighbors of each
+	chunk; a prefix sum over chunks then gives each chunk its first
+	row and first edge, so the second parallel pass parses its
+	neighbors straight into csr2, and writes csr1 for its rows as
+	running edge offsets.
+	Row i of the file is vertex i; its leading vertex id is skipped.
+*/
+void AdjlistReader::read(string infile, CSRArrays &g) {
+
+	size_t length;
+	const char* text = map_text(infile, length);
+	ParseChunk* chunks;
+	int num_chunks = split_chunks(text, length, chunks);
+
+	#pragma omp parallel for schedule(dynamic, 1)
+	for(int c=0; c<num_chunks; c++) {
+		count_chunk( chunks[c] );
+	}
+
+	long long total_rows = 0;
+	long long total_edges = 0;
+	bool weighted = false;
+	for(int c=0; c<num_chunks; c++) {
+		chunks[c].first_line = total_rows;
+		chunks[c].first_item = total_edges;
+		total_rows += chunks[c].num_lines;
+		total_edges += chunks[c].num_items;
+		weighted = weighted || chunks[c].weighted;
+	}
+	if( total_rows >= INT_MAX ) {
+		printf("too many vertices for 32-bit indices in %s: %lld\n", infile.c_str(), total_rows);
+		exit(1);
+	}
+	if( total_edges > EID_MAX ) {
+		printf("too many edges for 32-bit edge offsets in %s: %lld, rebuild with -DBC_WIDE_EDGES\n", infile.c_str(), total_edges);
+		exit(1);
+	}
+
+	g.num_verts = total_rows;
+	g.num_edges = total_edges;
+	g.csr1 = new eid_t[g.num_verts+1];
+	g.csr2 = new int[g.num_edges];
+	g.weights = weighted ? new int[g.num_edges] : NULL;
+	g.orig_ids = NULL;
+	g.csr1[0] = 0;
+
+	bool bad = false;
+	#pragma omp parallel for schedule(dynamic, 1) reduction(||:bad)
+	for(int c=0; c<num_chunks; c++) {
+		if( !parse_chunk( chunks[c], g, infile ) ) {
+			bad = true;
+		}
+	}
+	if( bad ) {
+		printf("bad adjacency list: %s\n", infile.c_str());
+		exit(1);
+	}
+
+	delete [] chunks;
+	unmap_text(text, length);
+	return;
+}
@@ -0,0 +1,363 @@
+/*
+	Edge list and MatrixMarket readers implementation, edgelist_reader.cpp
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Parses files of one edge per line in parallel, then builds
+	CSR by sorting the edges, see graph_reader.h
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#include<cstdio>
+#include<cstdlib>
+#include<cstring>
+#include<climits>
+#include<omp.h>
+
+#include "graph_reader.h"
+#include "radix_sort.h"
+
+static inline bool is_space(char c) {
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+static inline bool is_digit(char c) {
+	return c >= '0' && c <= '9';
+}
+
+/*
+	Count the edge lines of a chunk, those that are not
+	blank or # or % comments, and whether any has a third column
+*/
+static void count_edge_chunk(ParseChunk &chunk) {
+	long long edges = 0;
+	bool weighted = false;
+	const char* p = chunk.begin;
+	while( p < chunk.end ) {
+		while( p < chunk.end && is_space(*p) ) p++;
+		if( p < chunk.end && *p != '\n' && *p != '#' && *p != '%' ) {
+			int tokens = 0;
+			while( p < chunk.end && *p != '\n' ) {
+				while( p < chunk.end && is_space(*p) ) p++;
+				if( p == chunk.end || *p == '\n' ) break;
+				tokens++;
+				while( p < chunk.end && !is_space(*p) && *p != '\n' ) p++;
+			}
+			edges++;
+			if( tokens > 2 ) weighted = true;
+		}
+		while( p < chunk.end && *p != '\n' ) p++;
+		p++;
+	}
+	chunk.num_items = edges;
+	chunk.weighted = weighted;
+}
+
+/*
+	Parse a vertex id at p, an unsigned 64-bit integer,
+	advancing p past it.
+	Returns false if there is no id or it overflows
+*/
+static inline bool parse_id(const char* &p, const char* end, uint64 &id) {
+	const char* digits = p;
+	bool overflow = false;
+	id = 0;
+	while( p < end && is_digit(*p) ) {
+		uint64 digit = *p - '0';
+		overflow = overflow || id > (~0ULL - digit) / 10;
+		id = id*10 + digit;
+		p++;
+	}
+	return p != digits && !overflow && (p == end || is_space(*p) || *p == '\n');
+}
+
+/*
+	Parse a weight at p, advancing p past it.
+	Returns -1 unless the weight is a positive integer
+*/
+static inline long long parse_edge_weight(const char* &p, const char* end) {
+	const char* digits = p;
+	long long weight = 0;
+	while( p < end && is_digit(*p) ) {
+		if( weight <= INT_MAX ) weight = weight*10 + (*p - '0');
+		p++;
+	}
+	if( p == digits || (p < end && !is_space(*p) && *p != '\n') || weight < 1 || weight > INT_MAX ) {
+		return -1;
+	}
+	return weight;
+}
+
+/* the length of the line starting at p, without its newline */
+static inline int line_length(const char* p, const char* end) {
+	const char* q = p;
+	while( q < end && *q != '\n' && *q != '\r' ) q++;
+	return int(q - p);
+}
+
+/*
+	Parse the edges of a chunk into src, dst, and w if not NULL,
+	starting at the chunk's first edge.  Ids are reduced by base.
+	Lines without a weight have weight 1; columns past the third,
+	and past the second if w is NULL, are ignored.
+	Returns false on a malformed line
+*/
+static bool parse_edge_chunk(ParseChunk &chunk, uint64* src, uint64* dst, int* w, int base, string infile) {
+	const char* p = chunk.begin;
+	const char* end = chunk.end;
+	long long edge = chunk.first_item;
+	while( p < end ) {
+		while( p < end && is_space(*p) ) p++;
+		if( p < end && *p != '\n' && *p != '#' && *p != '%' ) {
+			const char* line = p;
+			uint64 u, v;
+			bool ok = parse_id(p, end, u);
+			while( p < end && is_space(*p) ) p++;
+			ok = parse_id(p, end, v) && ok;
+			if( !ok || u < uint64(base) || v < uint64(base) ) {
+				printf("bad edge in %s: %.*s\n", infile.c_str(), line_length(line, end), line);
+				return false;
+			}
+			src[edge] = u - base;
+			dst[edge] = v - base;
+			while( p < end && is_space(*p) ) p++;
+			if( w != NULL ) {
+				w[edge] = 1;
+				if( p < end && *p != '\n' ) {
+					long long weight = parse_edge_weight(p, end);
+					if( weight < 0 ) {
+						printf("bad edge weight in %s: %.*s\n", infile.c_str(), line_length(line, end), line);
+						return false;
+					}
+					w[edge] = weight;
+				}
+			}
+			edge++;
+		}
+		while( p < end && *p != '\n' ) p++;
+		p++;
+	}
+	return true;
+}
+
+/*
+	Count and parse the edges of text in parallel, allocating
+	src, dst and, if any edge has a weight or weighted is set, w,
+	unless values is false, when columns past the second are ignored.
+	Returns the number of edges
+*/
+static long long read_edges(const char* text, size_t length, int base, bool weighted, bool values,
+		uint64* &src, uint64* &dst, int* &w, string infile) {
+
+	ParseChunk* chunks;
+	int num_chunks = split_chunks(text, length, chunks);
+
+	#pragma omp parallel for schedule(dynamic, 1)
+	for(int c=0; c<num_chunks; c++) {
+		count_edge_chunk( chunks[c] );
+	}
+
+	long long num_pairs = 0;
+	for(int c=0; c<num_chunks; c++) {
+		chunks[c].first_item = num_pairs;
+		num_pairs += chunks[c].num_items;
+		weighted = weighted || chunks[c].weighted;
+	}
+
+	src = new uint64[num_pairs];
+	dst = new uint64[num_pairs];
+	w = (weighted && values) ? new int[num_pairs] : NULL;
+
+	bool bad = false;
+	#pragma omp parallel for schedule(dynamic, 1) reduction(||:bad)
+	for(int c=0; c<num_chunks; c++) {
+		if( !parse_edge_chunk( chunks[c], src, dst, w, base, infile ) ) {
+			bad = true;
+		}
+	}
+	if( bad ) {
+		exit(1);
+	}
+
+	delete [] chunks;
+	return num_pairs;
+}
+
+/* the position of id in the n sorted ids, which contain it */
+static inline int lower_bound_id(uint64* ids, long long n, uint64 id) {
+	long long lo = 0;
+	long long hi = n - 1;
+	while( lo < hi ) {
+		long long mid = (lo + hi) / 2;
+		if( ids[mid] < id ) lo = mid + 1;
+		else hi = mid;
+	}
+	return lo;
+}
+
+/***** EdgelistReader *****/
+
+int EdgelistReader::get_format() {
+	return FORMAT_EDGELIST;
+}
+
+/*
+	Load a graph from an edge list.
+	The ids of vertices on any edge other than a self loop
+	are sorted and deduplicated, and each id is replaced
+	by its position, found by binary search.  The sorted
+	ids are kept as orig_ids unless they are 0..n-1
+*/
+void EdgelistReader::read(string infile, CSRArrays &g) {
+
+	size_t length;
+	const char* text = map_text(infile, length);
+	uint64* src;
+	uint64* dst;
+	int* w;
+	long long num_pairs = read_edges(text, length, 0, false, true, src, dst, w, infile);
+	unmap_text(text, length);
+
+	// a self loop adds no vertex; it repeats the ids of an edge that does
+	long long first = 0;
+	while( first < num_pairs && src[first] == dst[first] ) first++;
+
+	uint64* ids = (uint64*)malloc( 2*num_pairs*sizeof(uint64) + 1 );
+	if( ids == NULL ) {
+		printf("bad malloc relabeling %s\n", infile.c_str());
+		exit(1);
+	}
+	#pragma omp parallel for
+	for(long long i=0; i<num_pairs; i++) {
+		bool loop = ( src[i] == dst[i] );
+		ids[2*i] = loop ? src[first] : src[i];
+		ids[2*i+1] = loop ? dst[first] : dst[i];
+	}
+	long long num_ids = (first < num_pairs) ? 2*num_pairs : 0;
+	radix_sort(ids, NULL, num_ids);
+	num_ids = unique_sorted(ids, NULL, num_ids);
+	if( num_ids >= INT_MAX ) {
+		printf("too many vertices for 32-bit indices in %s: %lld\n", infile.c_str(), num_ids);
+		exit(1);
+	}
+
+	int* isrc = new int[num_pairs];
+	int* idst = new int[num_pairs];
+	#pragma omp parallel for
+	for(long long i=0; i<num_pairs; i++) {
+		if( src[i] == dst[i] ) {
+			isrc[i] = 0;
+			idst[i] = 0;
+			continue;
+		}
+		isrc[i] = lower_bound_id(ids, num_ids, src[i]);
+		idst[i] = lower_bound_id(ids, num_ids, dst[i]);
+	}
+	delete [] src;
+	delete [] dst;
+
+	build_csr_from_edges(num_pairs, isrc, idst, w, num_ids, g);
+	delete [] isrc;
+	delete [] idst;
+	delete [] w;
+
+	if( num_ids > 0 && ids[num_ids-1] != uint64(num_ids-1) ) {
+		g.orig_ids = new uint64[num_ids];
+		memcpy( g.orig_ids, ids, num_ids*sizeof(uint64) );
+	}
+	free(ids);
+}
+
+/***** MatrixMarketReader *****/
+
+int MatrixMarketReader::get_format() {
+	return FORMAT_MATRIX_MARKET;
+}
+
+/*
+	Load a graph from a MatrixMarket coordinate file.
+	The banner gives the field, pattern for an unweighted graph,
+	or integer for weights; real and complex values are not
+	lengths this program can search, so those matrices are read
+	as patterns, unweighted.  Every symmetry is read as
+	an undirected graph.  Entries follow the comments and the
+	size line, rows columns entries, and are 1-based
+*/
+void MatrixMarketReader::read(string infile, CSRArrays &g) {
+
+	size_t length;
+	const char* text = map_text(infile, length);
+	const char* end = text + length;
+
+	// the banner line
+	char banner[256];
+	size_t len = 0;
+	while( len < length && len < sizeof(banner)-1 && text[len] != '\n' ) {
+		banner[len] = text[len];
+		len++;
+	}
+	banner[len] = '\0';
+	char object[64], layout[64], field[64], symmetry[64];
+	if( sscanf(banner, "%%%%MatrixMarket %63s %63s %63s %63s", object, layout, field, symmetry) != 4
+			|| strcmp(object, "matrix") != 0 || strcmp(layout, "coordinate") != 0 ) {
+		printf("not a MatrixMarket coordinate matrix: %s\n", infile.c_str());
+		exit(1);
+	}
+	bool weighted = ( strcmp(field, "integer") == 0 );
+	bool values = weighted || strcmp(field, "pattern") == 0;
+	if( !values ) {
+		if( strcmp(field, "real") != 0 && strcmp(field, "double") != 0 && strcmp(field, "complex") != 0 ) {
+			printf("unsupported MatrixMarket field in %s: %s\n", infile.c_str(), field);
+			exit(1);
+		}
+		printf("Ignoring %s values of %s, read as a pattern, every edge has length 1\n", field, infile.c_str());
+	}
+
+	// skip comments to the size line
+	const char* p = text;
+	while( p < end && (*p == '%' || *p == '\n') ) {
+		while( p < end && *p != '\n' ) p++;
+		p++;
+	}
+	char size_line[256];
+	len = 0;
+	while( p < end && len < sizeof(size_line)-1 && *p != '\n' ) {
+		size_line[len++] = *p++;
+	}
+	size_line[len] = '\0';
+	p++;
+	long long rows, cols, entries;
+	if( sscanf(size_line, "%lld %lld %lld", &rows, &cols, &entries) != 3 || rows != cols || rows >= INT_MAX ) {
+		printf("bad MatrixMarket size line in %s: %s\n", infile.c_str(), size_line);
+		exit(1);
+	}
+
+	if( p > end ) p = end;
+	uint64* src;
+	uint64* dst;
+	int* w;
+	long long num_pairs = read_edges(p, end-p, 1, weighted, values, src, dst, w, infile);
+	unmap_text(text, length);
+
+	int* isrc = new int[num_pairs];
+	int* idst = new int[num_pairs];
+	bool bad = false;
+	#pragma omp parallel for reduction(||:bad)
+	for(long long i=0; i<num_pairs; i++) {
+		bad = bad || src[i] >= uint64(rows) || dst[i] >= uint64(rows);
+		isrc[i] = src[i];
+		idst[i] = dst[i];
+	}
+	if( bad ) {
+		printf("MatrixMarket entry out of range in %s\n", infile.c_str());
+		exit(1);
+	}
+	delete [] src;
+	delete [] dst;
+
+	build_csr_from_edges(num_pairs, isrc, idst, w, rows, g);
+	delete [] isrc;
+	delete [] idst;
+	delete [] w;
+}
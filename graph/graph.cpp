@@ -4,39 +4,108 @@
 
 	primarily developed for loading a graph from file into CSR format
 
-	reads adjacency list graphfile into adjacency list data structure representation, 
-	then converts the adjacency list to CSR (Compressed Sparse Row) format
+	text graphs are parsed by a GraphReader directly into CSR
+	(Compressed Sparse Row) format; binary graphs are mapped
 
 	This software is distributed under 
 	the modified Berkeley Software Distribution (BSD) License.
 */
 
-#include<fstream>
-using std::ifstream;
-
 #include<cstdlib>
-using std::atoi;
+using std::exit;
+
+#include<cstdio>
+#include<cstring>
+#include<climits>
 
-#include<iostream>
-using std::cout;
-using std::endl;
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<fcntl.h>
+#include<unistd.h>
 
 #include "graph.h"
+#include "graph_binary.h"
+#include "graph_reader.h"
+#include "radix_sort.h"
 
 /* Constructor */
-Graph::Graph(string infile) {
+Graph::Graph(string infile, bool use_cache, int text_format) {
 
 	filename = infile;
-	create_adjlist_from_file(filename);
-	create_csr_from_adjlist();
-	remove_adjlist();
+	format = text_format;
+	weighted = false;
+	weights = NULL;
+	orig_ids = NULL;
+	old_ids = NULL;
+	new_ids = NULL;
+	mapped = false;
+	map_addr = NULL;
+	map_length = 0;
+
+	string cachefile = infile + BCSR_EXTENSION;
+	if( is_binary_graph(infile) ) {
+		if( !map_binary(infile, "", FORMAT_AUTO) ) {
+			printf("bad binary graph file: %s\n", infile.c_str());
+			exit(1);
+		}
+	} else {
+		// a cache is only used if read as the format this load would read
+		int source_format = FORMAT_AUTO;
+		if( use_cache ) {
+			GraphReader* reader = choose_reader(infile, text_format);
+			source_format = reader->get_format();
+			delete reader;
+		}
+		if( !( use_cache && map_binary(cachefile, infile, source_format) ) ) {
+			read_text(filename, text_format);
+			if( use_cache && !write_binary_graph(cachefile, num_verts, num_edges, csr1, csr2, weights, orig_ids, infile, format) ) {
+				printf("could not write graph cache: %s\n", cachefile.c_str());
+			}
+		}
+	}
 
+	check_weights();
+	find_components();
 }
 
-/* Destructor */
+/*
+	Constructor from CSR arrays, which the Graph takes over
+	and deletes; weights and ids may be NULL
+*/
+Graph::Graph(int n, eid_t m, eid_t* row_offsets, int* neighbors, int* edge_weights, string name, uint64* ids) {
+	filename = name;
+	format = FORMAT_AUTO;
+	num_verts = n;
+	num_edges = m;
+	csr1 = row_offsets;
+	csr2 = neighbors;
+	weights = edge_weights;
+	weighted = ( weights != NULL );
+	orig_ids = ids;
+	old_ids = NULL;
+	new_ids = NULL;
+	mapped = false;
+	map_addr = NULL;
+	map_length = 0;
+	find_components();
+}
+
+/* Destructor, the arrays of a mapped graph belong to the mapping */
 Graph::~Graph() {
+	delete [] old_ids;
+	delete [] new_ids;
+	delete [] comp_of;
+	delete [] comp_start;
+	delete [] comp_verts;
+	delete [] comp_edges;
+	if( mapped ) {
+		munmap( map_addr, map_length );
+		return;
+	}
 	delete [] csr1;
 	delete [] csr2;
+	delete [] weights;
+	delete [] orig_ids;
 }
 
 /* num verts accessor */
@@ -45,16 +114,16 @@ int Graph::get_num_verts() {
 }
 
 /* num undirected edges accessor */
-int Graph::get_num_undir_edges() {
+eid_t Graph::get_num_undir_edges() {
 	return (num_edges/2);
 }
 
 /* num directed edges accessor */
-int Graph::get_num_dir_edges() {
+eid_t Graph::get_num_dir_edges() {
 	return num_edges;
 }
 
-int* Graph::get_csr1() {
+eid_t* Graph::get_csr1() {
 	return csr1;
 }
 
@@ -62,176 +131,437 @@ int* Graph::get_csr2() {
 	return csr2;
 }
 
-int Graph::get_degree(int v) {
-	return csr1[v+1] - csr1[v];
+/* edge weights parallel to csr2, NULL if unweighted */
+int* Graph::get_weights() {
+	return weights;
 }
 
-string Graph::get_filename() {
-	return filename;
+/* original vertex ids, NULL if vertices kept their ids */
+uint64* Graph::get_orig_ids() {
+	return orig_ids;
 }
 
-/***** Private functions *****/
+/* the original id of vertex v */
+uint64 Graph::get_orig_id(int v) {
+	int loaded = (old_ids != NULL) ? old_ids[v] : v;
+	return (orig_ids != NULL) ? orig_ids[loaded] : uint64(loaded);
+}
 
 /*
-	Create an internal representation of
-	an adjacency list from an
-	adjacency list graph file
+	The vertex with original id, by binary search of the
+	sorted ids.  Returns -1 if there is none
 */
-void Graph::create_adjlist_from_file(string infile) {
-
-	num_verts = read_adjlist_rows(infile);
-	num_neighbors= new int[num_verts];
-	adjlist=new int*[num_verts];
-	read_row_neighbors(infile);
-	int row_size;
-	num_edges=0;
-	for(int i=0; i<num_verts; i++) {
-		row_size = num_neighbors[i];
-		adjlist[i]=new int[row_size];
-		num_edges+=row_size;
+int Graph::find_vertex(uint64 id) {
+	int loaded = -1;
+	if( orig_ids == NULL ) {
+		loaded = (id < uint64(num_verts)) ? int(id) : -1;
+	} else {
+		int lo = 0;
+		int hi = num_verts;
+		while( lo < hi ) {
+			int mid = lo + (hi - lo) / 2;
+			if( orig_ids[mid] < id ) lo = mid + 1;
+			else hi = mid;
+		}
+		loaded = (lo < num_verts && orig_ids[lo] == id) ? lo : -1;
 	}
-	read_adjlist(infile);
-	return;
+	return (loaded >= 0 && new_ids != NULL) ? new_ids[loaded] : loaded;
+}
+
+/* the vertex each index as loaded became, NULL if not reordered */
+int* Graph::get_new_ids() {
+	return new_ids;
 }
 
 /*
-	Create a graph in the compressed sparse row format
-	from the adjacency list format
+	Renumber the vertices, order[i] becoming vertex i, and
+	rebuild the CSR arrays in the new numbering.  Rows keep their
+	edges and weights, and neighbors are sorted again, by a radix
+	sort of every edge keyed by its new endpoints.  A mapped graph
+	is copied out of its mapping, which is released
 */
-void Graph::create_csr_from_adjlist() {
-	csr1=new int[num_verts+1];
-	csr2=new int[num_edges];
-	int row_size=0;
-	int edge_count=0;
-	csr1[0]=0;
+void Graph::reorder(int* order) {
+
+	int* position = new int[num_verts];
+	#pragma omp parallel for
 	for(int i=0; i<num_verts; i++) {
-		row_size=num_neighbors[i];
-		for(int j=0; j<row_size; j++) {
-			csr2[edge_count] = adjlist[i][j];
-			edge_count++;
+		position[order[i]] = i;
+	}
+
+	eid_t* new_csr1 = new eid_t[num_verts+1];
+	new_csr1[0] = 0;
+	for(int i=0; i<num_verts; i++) {
+		new_csr1[i+1] = new_csr1[i] + ( csr1[order[i]+1] - csr1[order[i]] );
+	}
+
+	uint64* keys = (uint64*)malloc( num_edges*sizeof(uint64) + 1 );
+	int* values = weighted ? (int*)malloc( num_edges*sizeof(int) + 1 ) : NULL;
+	if( keys == NULL || (weighted && values == NULL) ) {
+		printf("bad malloc reordering graph: %lld edges\n", (long long)num_edges);
+		exit(1);
+	}
+	#pragma omp parallel for schedule(dynamic, 1024)
+	for(int i=0; i<num_verts; i++) {
+		int u = order[i];
+		eid_t out = new_csr1[i];
+		for(eid_t j=csr1[u]; j<csr1[u+1]; j++, out++) {
+			keys[out] = ( uint64(i) << 32 ) | (unsigned int)position[ csr2[j] ];
+			if( weighted ) {
+				values[out] = weights[j];
+			}
 		}
-		csr1[i+1]=edge_count;
 	}
-	return;
+	radix_sort(keys, values, num_edges);
+
+	int* new_csr2 = new int[num_edges];
+	int* new_weights = weighted ? new int[num_edges] : NULL;
+	#pragma omp parallel for
+	for(eid_t j=0; j<num_edges; j++) {
+		new_csr2[j] = int(keys[j] & 0xFFFFFFFFULL);
+		if( weighted ) {
+			new_weights[j] = values[j];
+		}
+	}
+	free(keys);
+	free(values);
+
+	// ids stay in the order loaded
+	uint64* ids = orig_ids;
+	if( mapped && orig_ids != NULL ) {
+		ids = new uint64[num_verts];
+		memcpy( ids, orig_ids, num_verts*sizeof(uint64) );
+	}
+	if( mapped ) {
+		munmap( map_addr, map_length );
+		mapped = false;
+		map_addr = NULL;
+		map_length = 0;
+	} else {
+		delete [] csr1;
+		delete [] csr2;
+		delete [] weights;
+	}
+	csr1 = new_csr1;
+	csr2 = new_csr2;
+	weights = new_weights;
+	orig_ids = ids;
 
+	// compose with an earlier renumbering
+	int* loaded = new int[num_verts];
+	for(int i=0; i<num_verts; i++) {
+		loaded[i] = (old_ids != NULL) ? old_ids[order[i]] : order[i];
+	}
+	delete [] old_ids;
+	old_ids = loaded;
+	if( new_ids == NULL ) {
+		new_ids = new int[num_verts];
+	}
+	for(int i=0; i<num_verts; i++) {
+		new_ids[old_ids[i]] = i;
+	}
+	delete [] position;
+
+	delete [] comp_of;
+	delete [] comp_start;
+	delete [] comp_verts;
+	delete [] comp_edges;
+	find_components();
 }
 
-/*
-	delete and free the memory of 
-	an adjacency list
-*/
-void Graph::remove_adjlist() {
-	for(int i=0; i<num_verts; i++)
-		delete [] adjlist[i];
-	delete [] adjlist;
-	delete [] num_neighbors;
-	return;
+int Graph::get_degree(int v) {
+	return csr1[v+1] - csr1[v];
+}
+
+int Graph::get_num_components() {
+	return num_components;
+}
+
+/* the connected component of vertex v */
+int Graph::get_component(int v) {
+	return comp_of[v];
+}
+
+/* the number of vertices in component c */
+int Graph::get_component_size(int c) {
+	return comp_start[c+1] - comp_start[c];
+}
+
+/* the vertices of component c, in increasing order */
+int* Graph::get_component_verts(int c) {
+	return &comp_verts[ comp_start[c] ];
+}
+
+/* the number of directed edges in component c */
+eid_t Graph::get_component_edges(int c) {
+	return comp_edges[c];
 }
 
+/* true if the graph has edge weights */
+bool Graph::is_weighted() {
+	return weighted;
+}
+
+/* true if the CSR arrays are mapped from a binary graph file */
+bool Graph::is_mapped() {
+	return mapped;
+}
+
+/* the GraphFormat the graph was read from, FORMAT_AUTO if not text */
+int Graph::get_format() {
+	return format;
+}
+
+string Graph::get_filename() {
+	return filename;
+}
+
+/***** Private functions *****/
+
 /*
-	Compute the number of rows (and thus vertices)
-	in an adjacency list file
+	The root of v's tree in a union-find forest, halving
+	the path on the way.  Roots only ever hook under smaller
+	roots, so a halved path still leads to the same root
 */
-int Graph::read_adjlist_rows(string infile) {
-	ifstream instream;
-	instream.open(infile.c_str());
-	string line;
-	int num_rows=0;
-	while( getline( instream, line) )
-		num_rows++;
-	instream.close();
-	return num_rows;
+static inline int find_root(int* parent, int v) {
+	volatile int* p = parent;
+	while( p[v] != v ) {
+		int up = p[ p[v] ];
+		p[v] = up;
+		v = up;
+	}
+	return v;
+}
+
+/* join the trees of u and w, the larger root under the smaller */
+static inline void unite(int* parent, int u, int w) {
+	while( true ) {
+		u = find_root(parent, u);
+		w = find_root(parent, w);
+		if( u == w ) {
+			return;
+		}
+		if( u < w ) {
+			int swap_vert = u;
+			u = w;
+			w = swap_vert;
+		}
+		if( __sync_bool_compare_and_swap(&parent[u], u, w) ) {
+			return;
+		}
+	}
 }
 
 /*
-	Compute the number of neighbors for
-	each vertice in the adjacency list file
+	Exit unless every path length fits the int distances of the
+	weighted engines: a shortest path has fewer than num_verts
+	edges, and one more edge is added when it is relaxed, so
+	num_verts times the largest weight must fit
 */
-void Graph::read_row_neighbors(string infile) {
-	ifstream instream;
-	instream.open( infile.c_str() );
-	string line;
-	int row=0;
-	int neighbor_count=0;
-	while( getline( instream, line) ) {
-		neighbor_count=parse_row_neighbors( line );	
-		num_neighbors[row]=neighbor_count;
-		row++;
+void Graph::check_weights() {
+	if( !weighted ) {
+		return;
+	}
+	int max_weight = 0;
+	#pragma omp parallel for reduction(max:max_weight)
+	for(eid_t j=0; j<num_edges; j++) {
+		if( weights[j] > max_weight ) {
+			max_weight = weights[j];
+		}
+	}
+	long long limit = (num_verts > 0) ? INT_MAX / num_verts : INT_MAX;
+	if( max_weight > limit ) {
+		printf("edge weight %d too large in %s: paths of %d vertices need weights of at most %lld\n",
+			max_weight, filename.c_str(), num_verts, limit);
+		exit(1);
 	}
-	instream.close();
-	return;
 }
 
 /*
-	Parse a row of an adjacency list
-	Return the number of neighbors
+	Label the connected components, by a union-find over the edges
+	in parallel, each tree rooted at the lowest vertex of its
+	component, so components are numbered in order of their lowest
+	vertex.  The vertices of each are then listed by a counting sort
+	of the labels, which keeps them in order
 */
-int Graph::parse_row_neighbors( string line ) {
-	
-	int neighbor_count=0;
-	bool parsed_v=false;
-	for(int i=0; i<line.size(); i++) {
-		if( line[i] == ' ' ) {
-			if(parsed_v==false) {
-				parsed_v=true;
-			} else {
-				neighbor_count++;
+void Graph::find_components() {
+
+	comp_of = new int[num_verts];
+	comp_verts = new int[num_verts];
+	int* parent = comp_verts;
+	#pragma omp parallel for
+	for(int v=0; v<num_verts; v++) {
+		parent[v] = v;
+	}
+	#pragma omp parallel for schedule(dynamic, 1024)
+	for(int u=0; u<num_verts; u++) {
+		for(eid_t j=csr1[u]; j<csr1[u+1]; j++) {
+			if( csr2[j] < u ) {
+				unite(parent, u, csr2[j]);
 			}
-		}		
+		}
+	}
+	#pragma omp parallel for
+	for(int v=0; v<num_verts; v++) {
+		comp_of[v] = find_root(parent, v);
 	}
-	neighbor_count++;
 
-	return neighbor_count;
+	// number the roots, then relabel every vertex by its root's number
+	num_components = 0;
+	for(int v=0; v<num_verts; v++) {
+		if( comp_of[v] == v ) {
+			parent[v] = num_components++;
+		}
+	}
+	#pragma omp parallel for
+	for(int v=0; v<num_verts; v++) {
+		comp_of[v] = parent[ comp_of[v] ];
+	}
+
+	comp_start = new int[num_components+1];
+	comp_edges = new eid_t[num_components];
+	for(int c=0; c<=num_components; c++) {
+		comp_start[c] = 0;
+	}
+	for(int c=0; c<num_components; c++) {
+		comp_edges[c] = 0;
+	}
+	for(int v=0; v<num_verts; v++) {
+		comp_start[ comp_of[v]+1 ]++;
+		comp_edges[ comp_of[v] ] += csr1[v+1] - csr1[v];
+	}
+	for(int c=0; c<num_components; c++) {
+		comp_start[c+1] += comp_start[c];
+	}
+	int* next = new int[num_components];
+	for(int c=0; c<num_components; c++) {
+		next[c] = comp_start[c];
+	}
+	for(int v=0; v<num_verts; v++) {
+		comp_verts[ next[comp_of[v]]++ ] = v;
+	}
+
+	delete [] next;
+}
+
+/* read a text graph with the reader for its format */
+void Graph::read_text( string infile, int text_format ) {
+	GraphReader* reader = choose_reader(infile, text_format);
+	CSRArrays g;
+	reader->read(infile, g);
+	format = reader->get_format();
+	delete reader;
+
+	num_verts = g.num_verts;
+	num_edges = g.num_edges;
+	csr1 = g.csr1;
+	csr2 = g.csr2;
+	weights = g.weights;
+	weighted = ( weights != NULL );
+	orig_ids = g.orig_ids;
 }
 
 /*
-	Read in an adjacency list and
-	parse each row
+	Whether mapped CSR arrays are a graph: csr1 runs from 0 to
+	num_edges without decreasing, every neighbor is a vertex,
+	and every weight is positive.  Rows are checked in parallel,
+	each row's edges only if its offsets are in range
 */
-void Graph::read_adjlist(string infile) {
-
-	ifstream instream;
-	instream.open( infile.c_str() );
-	string line;
-	int row_count=0;
-	while( getline( instream, line ) ) {
-		parse_adjlist_row( line, adjlist[row_count] );
-		row_count++;
+static bool valid_csr(int num_verts, eid_t num_edges, eid_t* csr1, int* csr2, int* weights) {
+	if( csr1[0] != 0 || csr1[num_verts] != num_edges ) {
+		return false;
 	}
-
-	return;
+	bool bad = false;
+	#pragma omp parallel for schedule(dynamic, 1024) reduction(||:bad)
+	for(int v=0; v<num_verts; v++) {
+		if( csr1[v] > csr1[v+1] || csr1[v+1] > num_edges ) {
+			bad = true;
+			continue;
+		}
+		for(eid_t j=csr1[v]; j<csr1[v+1]; j++) {
+			if( csr2[j] < 0 || csr2[j] >= num_verts || (weights != NULL && weights[j] < 1) ) {
+				bad = true;
+				break;
+			}
+		}
+	}
+	return !bad;
 }
 
 /*
-	parse each row of an adjacency list.
-	Populate each row with the neighors
+	Map a binary CSR graph file and point the CSR arrays into it.
+	The mapping is private, so the arrays may be written without
+	changing the file.  If source is not empty, the file must have
+	been written from source as it is now, read as source_format.
+	Returns false, mapping nothing, if the file is missing,
+	malformed, stale, or of another edge offset width, or its
+	arrays are not a graph, see valid_csr
 */
-void Graph::parse_adjlist_row( string line, int* row ) {
-
-	string vert_str;
-	int start, length;
-	bool parsed_v=false;
-	start=0;
-	int vert;
-	int vert_count=0;
-	for(int i=0; i<line.size(); i++) {
-		if( line[i] == ' ' ) {
-			length=i-start;
-			vert_str = line.substr( start , length );
-			if(parsed_v==false) {
-				parsed_v=true;
-			} else {
-				vert = atoi(vert_str.c_str() );
-				row[vert_count] = vert;
-				vert_count++;
-			}
-			start=i+1;
-		}		
+bool Graph::map_binary( string binfile, string source, int source_format ) {
+
+	int fd = open( binfile.c_str(), O_RDONLY );
+	if( fd < 0 ) {
+		return false;
+	}
+	struct stat st;
+	if( fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(BCSR_header) ) {
+		close(fd);
+		return false;
+	}
+	size_t length = st.st_size;
+	void* addr = mmap( NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+	close(fd);
+	if( addr == MAP_FAILED ) {
+		return false;
 	}
-	length=line.size()-start;
-	vert_str = line.substr( start , length );
-	vert = atoi(vert_str.c_str() );
-	row[vert_count] = vert;
 
-	return;
+	BCSR_header* header = (BCSR_header*)addr;
+	bool ok = ( memcmp(header->magic, BCSR_MAGIC, 4) == 0 )
+		&& header->version == BCSR_VERSION
+		&& header->byte_order == BCSR_BYTE_ORDER
+		&& ( (header->flags & BCSR_WIDE_EDGES) != 0 ) == ( sizeof(eid_t) == sizeof(long long) );
+	long long edges = binary_num_edges( *header );
+	ok = ok && header->num_verts >= 0 && edges >= 0 && edges <= EID_MAX;
+	if( ok ) {
+		size_t num_arrays = (header->flags & BCSR_WEIGHTED) ? 2 : 1;
+		size_t expected = sizeof(BCSR_header) + sizeof(eid_t) * ( size_t(header->num_verts) + 1 )
+			+ sizeof(int) * num_arrays * size_t(edges);
+		if( header->flags & BCSR_ORIG_IDS ) {
+			expected = binary_ids_offset( header->num_verts, edges, num_arrays == 2 )
+				+ sizeof(uint64) * size_t(header->num_verts);
+		}
+		ok = ( length == expected );
+	}
+	if( ok && !source.empty() ) {
+		long long size, mtime_sec, mtime_nsec;
+		ok = stat_source( source, size, mtime_sec, mtime_nsec )
+			&& size == header->source_size
+			&& mtime_sec == header->source_mtime_sec
+			&& mtime_nsec == header->source_mtime_nsec
+			&& header->source_format == source_format;
+	}
+	if( ok ) {
+		eid_t* offsets = (eid_t*)( (char*)addr + sizeof(BCSR_header) );
+		int* neighbors = (int*)( offsets + header->num_verts + 1 );
+		int* edge_weights = (header->flags & BCSR_WEIGHTED) ? neighbors + edges : NULL;
+		ok = valid_csr( header->num_verts, edges, offsets, neighbors, edge_weights );
+	}
+	if( !ok ) {
+		munmap( addr, length );
+		return false;
+	}
+
+	num_verts = header->num_verts;
+	num_edges = edges;
+	csr1 = (eid_t*)( (char*)addr + sizeof(BCSR_header) );
+	csr2 = (int*)( csr1 + num_verts + 1 );
+	weighted = ( header->flags & BCSR_WEIGHTED ) != 0;
+	weights = weighted ? csr2 + num_edges : NULL;
+	orig_ids = NULL;
+	if( header->flags & BCSR_ORIG_IDS ) {
+		orig_ids = (uint64*)( (char*)addr + binary_ids_offset( num_verts, num_edges, weighted ) );
+	}
+	mapped = true;
+	map_addr = addr;
+	map_length = length;
+	return true;
 }
@@ -5,6 +5,45 @@
 	Reads in a graph from an adjacency list,
 	stores graph in compressed sparse row format
 
+	Text graphs, adjacency lists, edge lists, or MatrixMarket files,
+	are read by a GraphReader, see graph_reader.h; format is a
+	GraphFormat, FORMAT_AUTO to choose by the file.
+	A Graph may also be built from CSR arrays, which it takes over.
+
+	Neighbors may carry an edge weight, written neighbor:weight.
+	Weights are stored in an array parallel to csr2,
+	so the weight of edge csr2[i] is weights[i].  A graph is
+	rejected unless num_verts times its largest weight fits
+	in an int, so path lengths do not overflow.
+	Unweighted graphs have no weights array.
+
+	A graph read with sparse vertex ids, such as 64-bit ids
+	in an edge list, is relabeled to 0..n-1; orig_ids holds the
+	original id of each vertex, for writing results, and is NULL
+	if the vertices kept their ids.  It is stored in binary graphs.
+
+	A graph may be renumbered after load for locality, see
+	reorder.h; old_ids then holds the index each vertex was
+	loaded with, and new_ids the inverse.  orig_ids stays in
+	the order loaded, so get_orig_id and find_vertex see through
+	the renumbering, and results are written in the order loaded.
+
+	Connected components are found once, when the graph is built
+	or renumbered, so a search can be bounded to its source's
+	component: get_component_verts lists the vertices of a
+	component in increasing order, and get_component_edges counts
+	their directed edges.
+
+	Edge offsets, csr1 and the number of edges, are eid_t,
+	int unless built for more edges, see graph_types.h.
+
+	A graph in the binary CSR format, see graph_binary.h,
+	is mapped into memory rather than read, and its arrays
+	point into the mapping.  With use_cache, a text graph is
+	loaded from a binary copy beside it, infile.bcsr, if the copy
+	is newer than the text; otherwise the text is parsed and
+	the copy written for the next load.
+
 	This software is distributed under 
 	the modified Berkeley Software Distribution (BSD) License.
 */
@@ -15,44 +54,69 @@
 #include<string>
 using std::string;
 
+#include "graph_reader.h"
+
 class Graph{
 
 	/* constructor, destructor, and public accessor functions */
 	public:
 
-		Graph(string);
+		Graph(string, bool use_cache = false, int format = FORMAT_AUTO);
+		Graph(int, eid_t, eid_t*, int*, int*, string, uint64* ids = NULL);
 		~Graph();
 		int get_num_verts();
-		int get_num_undir_edges();
-		int get_num_dir_edges();
-		int* get_csr1();
+		eid_t get_num_undir_edges();
+		eid_t get_num_dir_edges();
+		eid_t* get_csr1();
 		int* get_csr2();
+		int* get_weights();
+		uint64* get_orig_ids();
+		uint64 get_orig_id(int);
+		int find_vertex(uint64);
+		int* get_new_ids();
+		void reorder(int*);
 		int get_degree(int);
+		int get_num_components();
+		int get_component(int);
+		int get_component_size(int);
+		int* get_component_verts(int);
+		eid_t get_component_edges(int);
+		bool is_weighted();
+		bool is_mapped();
+		int get_format();
 		string get_filename();
 
 
 	/* private functions */
 	private:
 
-		void create_adjlist_from_file(string infile);
-		void create_csr_from_adjlist();
-		void remove_adjlist();
-		int read_adjlist_rows(string infile);
-		void read_row_neighbors(string infile);
-		int parse_row_neighbors(string line);
-		void read_adjlist(string infile);
-		void parse_adjlist_row( string line, int* row );
+		void read_text( string infile, int format );
+		bool map_binary( string binfile, string source, int source_format );
+		void check_weights();
+		void find_components();
 
 
 	/* private variables */
 	private:
 		int num_verts;
-		int num_edges;
-		int* csr1;
+		eid_t num_edges;
+		bool weighted;
+		eid_t* csr1;
 		int* csr2;
-		int* num_neighbors;
-		int** adjlist;
+		int* weights;
+		uint64* orig_ids;
+		int* old_ids;
+		int* new_ids;
+		int num_components;
+		int* comp_of;
+		int* comp_start;
+		int* comp_verts;
+		eid_t* comp_edges;
 		string filename;
+		int format;
+		bool mapped;
+		void* map_addr;
+		size_t map_length;
 
 };
 
@@ -0,0 +1,122 @@
+/*
+	Binary CSR graph format implementation, graph_binary.cpp
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Writes graphs in the binary CSR format, see graph_binary.h.
+	Reading is done by Graph, which maps the file in place.
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#include<cstdio>
+#include<cstring>
+#include<sys/stat.h>
+
+#include "graph_binary.h"
+
+/* true if the file begins with the binary CSR magic */
+bool is_binary_graph(string infile) {
+	FILE* f = fopen( infile.c_str(), "rb" );
+	if( f == NULL ) {
+		return false;
+	}
+	char magic[4];
+	bool binary = ( fread(magic, 1, 4, f) == 4 && memcmp(magic, BCSR_MAGIC, 4) == 0 );
+	fclose(f);
+	return binary;
+}
+
+/*
+	Size and modification time of a file.
+	Returns false if the file cannot be read
+*/
+bool stat_source(string infile, long long &size, long long &mtime_sec, long long &mtime_nsec) {
+	struct stat st;
+	if( stat( infile.c_str(), &st ) != 0 ) {
+		return false;
+	}
+	size = st.st_size;
+	mtime_sec = st.st_mtim.tv_sec;
+	mtime_nsec = st.st_mtim.tv_nsec;
+	return true;
+}
+
+/*
+	Fill in the header of a binary graph, recording the size
+	and modification time of source unless it is empty, and
+	the format source was read as, 0 if there is none.
+	Shared with writers that stream the arrays, such as the
+	out-of-core edge list converter
+*/
+void init_binary_header(BCSR_header &header, int num_verts, eid_t num_edges, bool weighted, bool has_ids, string source, int source_format) {
+	memset( &header, 0, sizeof(header) );
+	memcpy( header.magic, BCSR_MAGIC, 4 );
+	header.version = BCSR_VERSION;
+	header.byte_order = BCSR_BYTE_ORDER;
+	header.flags = (weighted ? BCSR_WEIGHTED : 0) | (has_ids ? BCSR_ORIG_IDS : 0);
+	header.num_verts = num_verts;
+	if( sizeof(eid_t) == sizeof(long long) ) {
+		header.flags |= BCSR_WIDE_EDGES;
+		header.wide_num_edges = num_edges;
+	} else {
+		header.num_edges = num_edges;
+	}
+	header.source_size = -1;
+	header.source_format = source_format;
+	if( !source.empty() ) {
+		stat_source( source, header.source_size, header.source_mtime_sec, header.source_mtime_nsec );
+	}
+}
+
+/* the number of edges of a binary graph, by the width of its csr1 */
+long long binary_num_edges(const BCSR_header &header) {
+	return (header.flags & BCSR_WIDE_EDGES) ? header.wide_num_edges : header.num_edges;
+}
+
+/* the offset of orig_ids in a binary graph, past the CSR arrays and padding */
+size_t binary_ids_offset(int num_verts, eid_t num_edges, bool weighted) {
+	size_t num_arrays = weighted ? 2 : 1;
+	size_t offset = sizeof(BCSR_header) + sizeof(eid_t) * ( size_t(num_verts) + 1 )
+		+ sizeof(int) * num_arrays * size_t(num_edges);
+	return (offset + 7) & ~size_t(7);
+}
+
+/*
+	Write a graph's CSR arrays to outfile; weights and orig_ids
+	may be NULL.
+	If source is not empty, its size and modification time, and
+	the format it was read as, are recorded, for checking a
+	cache against its text graph.
+	The file is written under a temporary name, then renamed,
+	so a reader never sees a partial file.
+	Returns false if the file cannot be written
+*/
+bool write_binary_graph(string outfile, int num_verts, eid_t num_edges, eid_t* csr1, int* csr2, int* weights, uint64* orig_ids, string source, int source_format) {
+
+	BCSR_header header;
+	init_binary_header( header, num_verts, num_edges, weights != NULL, orig_ids != NULL, source, source_format );
+
+	string tmpfile = outfile + ".tmp";
+	FILE* f = fopen( tmpfile.c_str(), "wb" );
+	if( f == NULL ) {
+		return false;
+	}
+	bool ok = ( fwrite( &header, sizeof(header), 1, f ) == 1 );
+	ok = ok && ( fwrite( csr1, sizeof(eid_t), num_verts+1, f ) == size_t(num_verts+1) );
+	ok = ok && ( fwrite( csr2, sizeof(int), num_edges, f ) == size_t(num_edges) );
+	if( weights != NULL ) {
+		ok = ok && ( fwrite( weights, sizeof(int), num_edges, f ) == size_t(num_edges) );
+	}
+	if( orig_ids != NULL ) {
+		size_t offset = binary_ids_offset( num_verts, num_edges, weights != NULL );
+		ok = ok && ( fseeko( f, offset, SEEK_SET ) == 0 );
+		ok = ok && ( fwrite( orig_ids, sizeof(uint64), num_verts, f ) == size_t(num_verts) );
+	}
+	ok = ( fclose(f) == 0 ) && ok;
+	ok = ok && ( rename( tmpfile.c_str(), outfile.c_str() ) == 0 );
+	if( !ok ) {
+		remove( tmpfile.c_str() );
+	}
+	return ok;
+}
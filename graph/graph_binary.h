@@ -0,0 +1,72 @@
+/*
+	Binary CSR graph format header, graph_binary.h
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	A graph stored as its CSR arrays, so it loads with a
+	single mmap instead of parsing text.  The file is:
+
+		BCSR_header		64 bytes
+		csr1			num_verts+1 eid_t, see graph_types.h
+		csr2			num_edges ints
+		weights			num_edges ints, if BCSR_WEIGHTED
+		orig_ids		num_verts 64-bit ids, if BCSR_ORIG_IDS,
+					starting at the next multiple of 8 bytes
+
+	in the byte order of the machine that wrote it.
+	A build with 64-bit edge offsets sets BCSR_WIDE_EDGES;
+	csr1 then holds long longs, and the number of edges is
+	wide_num_edges rather than num_edges.  A file is only mapped
+	by a build whose csr1 has its width.
+	orig_ids is the relabeling of a graph read with sparse
+	vertex ids, see graph_reader.h, so it is not redone.
+	A file written as a cache of a text graph records the
+	size and modification time of the text file, and the
+	GraphFormat it was read as, so a stale cache, or one read
+	as another format, is detected and rewritten.
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#ifndef GRAPH_BINARY_H
+#define GRAPH_BINARY_H
+
+#include<string>
+using std::string;
+
+#include "graph_types.h"
+
+#define BCSR_MAGIC "BCSR"
+#define BCSR_VERSION 1
+#define BCSR_BYTE_ORDER 0x01020304
+#define BCSR_EXTENSION ".bcsr"
+
+/* header flags */
+#define BCSR_WEIGHTED 1
+#define BCSR_ORIG_IDS 2
+#define BCSR_WIDE_EDGES 4
+
+struct BCSR_header {
+	char magic[4];
+	int version;
+	int byte_order;
+	int flags;
+	int num_verts;
+	int num_edges;
+	long long source_size;
+	long long source_mtime_sec;
+	long long source_mtime_nsec;
+	long long wide_num_edges;
+	int source_format;
+	char reserved[4];
+};
+
+bool is_binary_graph(string);
+bool stat_source(string, long long&, long long&, long long&);
+
+void init_binary_header(BCSR_header&, int, eid_t, bool, bool, string, int source_format = 0);
+long long binary_num_edges(const BCSR_header&);
+size_t binary_ids_offset(int, eid_t, bool);
+bool write_binary_graph(string, int, eid_t, eid_t*, int*, int*, uint64*, string, int source_format = 0);
+
+#endif
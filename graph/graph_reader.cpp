@@ -0,0 +1,215 @@
+/*
+	Graph readers implementation, graph_reader.cpp
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Choosing a reader, and the mapping, chunking, and
+	CSR building shared by the readers, see graph_reader.h
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#include<cstdio>
+#include<cstdlib>
+#include<cstring>
+#include<climits>
+
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<fcntl.h>
+#include<unistd.h>
+#include<omp.h>
+
+#include "graph_reader.h"
+#include "radix_sort.h"
+
+/* true if name ends with ext */
+static bool has_extension(string name, const char* ext) {
+	size_t len = strlen(ext);
+	return name.size() >= len && name.compare(name.size()-len, len, ext) == 0;
+}
+
+/*
+	A reader for the format, or for FORMAT_AUTO, for the file:
+	a MatrixMarket banner or a .mtx extension is MatrixMarket,
+	a leading # comment or an edge list extension is an edge list,
+	and anything else is an adjacency list
+*/
+GraphReader* choose_reader(string infile, int format) {
+
+	if( format == FORMAT_AUTO ) {
+		char head[16];
+		memset( head, 0, sizeof(head) );
+		FILE* f = fopen( infile.c_str(), "rb" );
+		if( f != NULL ) {
+			size_t got = fread( head, 1, sizeof(head)-1, f );
+			head[got] = '\0';
+			fclose(f);
+		}
+		if( strncmp(head, "%%MatrixMarket", 14) == 0 || has_extension(infile, ".mtx") ) {
+			format = FORMAT_MATRIX_MARKET;
+		} else if( head[0] == '#' || has_extension(infile, ".edge_list") || has_extension(infile, ".edgelist")
+				|| has_extension(infile, ".edges") || has_extension(infile, ".el") ) {
+			format = FORMAT_EDGELIST;
+		} else {
+			format = FORMAT_ADJLIST;
+		}
+	}
+
+	switch( format ) {
+		case FORMAT_EDGELIST:
+			return new EdgelistReader();
+		case FORMAT_MATRIX_MARKET:
+			return new MatrixMarketReader();
+		default:
+			return new AdjlistReader();
+	}
+}
+
+const char* format_name(int format) {
+	switch( format ) {
+		case FORMAT_ADJLIST:
+			return "adjacency list";
+		case FORMAT_EDGELIST:
+			return "edge list";
+		case FORMAT_MATRIX_MARKET:
+			return "MatrixMarket";
+		default:
+			return "auto";
+	}
+}
+
+/*
+	Map a text file for reading, setting its length.
+	Returns NULL for an empty file; exits if it cannot be read
+*/
+const char* map_text(string infile, size_t &length) {
+
+	int fd = open( infile.c_str(), O_RDONLY );
+	struct stat st;
+	if( fd < 0 || fstat(fd, &st) != 0 ) {
+		printf("cannot open graph file: %s\n", infile.c_str());
+		exit(1);
+	}
+	length = st.st_size;
+	const char* text = NULL;
+	if( length > 0 ) {
+		void* addr = mmap( NULL, length, PROT_READ, MAP_PRIVATE, fd, 0 );
+		if( addr == MAP_FAILED ) {
+			printf("cannot map graph file: %s\n", infile.c_str());
+			exit(1);
+		}
+		madvise( addr, length, MADV_SEQUENTIAL );
+		text = (const char*)addr;
+	}
+	close(fd);
+	return text;
+}
+
+void unmap_text(const char* text, size_t length) {
+	if( text != NULL ) {
+		munmap( (void*)text, length );
+	}
+}
+
+/*
+	Split text into chunks that start at lines, a few per thread
+	and at least 1 MB each.  Allocates chunks; returns how many
+*/
+int split_chunks(const char* text, size_t length, ParseChunk* &chunks) {
+
+	int num_chunks = 4 * omp_get_max_threads();
+	if( size_t(num_chunks) > length / (1 << 20) + 1 ) {
+		num_chunks = length / (1 << 20) + 1;
+	}
+	chunks = new ParseChunk[num_chunks];
+	const char* file_end = text + length;
+	const char* prev = text;
+	for(int c=0; c<num_chunks; c++) {
+		const char* cut = (c == num_chunks-1) ? file_end : text + length / num_chunks * (c+1);
+		if( cut < prev ) cut = prev;
+		while( cut < file_end && cut > text && cut[-1] != '\n' ) cut++;
+		chunks[c].begin = prev;
+		chunks[c].end = cut;
+		chunks[c].num_lines = 0;
+		chunks[c].num_items = 0;
+		chunks[c].weighted = false;
+		prev = cut;
+	}
+	return num_chunks;
+}
+
+/*
+	Build an undirected CSR graph from num_pairs edges src[i]-dst[i],
+	with weights w, which may be NULL, on vertices 0..num_verts-1.
+	Each edge is stored in both directions as a key, source in the
+	high 32 bits and target in the low, with self loops dropped;
+	sorting the keys orders csr2 by row and then by neighbor, and a
+	repeated edge keeps its smallest weight.
+*/
+void build_csr_from_edges(long long num_pairs, int* src, int* dst, int* w, int num_verts, CSRArrays &out) {
+
+	uint64* keys = (uint64*)malloc( 2*num_pairs*sizeof(uint64) + 1 );
+	int* values = (w != NULL) ? (int*)malloc( 2*num_pairs*sizeof(int) + 1 ) : NULL;
+	if( keys == NULL || (w != NULL && values == NULL) ) {
+		printf("bad malloc building CSR: %lld edges\n", num_pairs);
+		exit(1);
+	}
+
+	// keep each edge's two directions together, blanking self loops
+	#pragma omp parallel for
+	for(long long i=0; i<num_pairs; i++) {
+		uint64 u = (unsigned int)src[i];
+		uint64 v = (unsigned int)dst[i];
+		if( u == v ) {
+			keys[2*i] = ~0ULL;
+			keys[2*i+1] = ~0ULL;
+		} else {
+			keys[2*i] = (u << 32) | v;
+			keys[2*i+1] = (v << 32) | u;
+		}
+		if( values != NULL ) {
+			values[2*i] = w[i];
+			values[2*i+1] = w[i];
+		}
+	}
+
+	long long n = 2*num_pairs;
+	radix_sort(keys, values, n);
+	n = unique_sorted(keys, values, n);
+	if( n > 0 && keys[n-1] == ~0ULL ) {
+		n--;
+	}
+	if( n > EID_MAX ) {
+		printf("too many edges for 32-bit edge offsets: %lld, rebuild with -DBC_WIDE_EDGES\n", n);
+		exit(1);
+	}
+
+	out.num_verts = num_verts;
+	out.num_edges = n;
+	out.csr1 = new eid_t[num_verts+1];
+	out.csr2 = new int[n];
+	out.weights = (w != NULL) ? new int[n] : NULL;
+	out.orig_ids = NULL;
+
+	// a row starts where the source of the key changes
+	#pragma omp parallel for
+	for(long long i=0; i<n; i++) {
+		int u = keys[i] >> 32;
+		out.csr2[i] = (int)(keys[i] & 0xFFFFFFFFULL);
+		if( values != NULL ) {
+			out.weights[i] = values[i];
+		}
+		int prev = (i == 0) ? -1 : int(keys[i-1] >> 32);
+		for(int r=prev+1; r<=u; r++) {
+			out.csr1[r] = i;
+		}
+	}
+	int last = (n == 0) ? -1 : int(keys[n-1] >> 32);
+	for(int r=last+1; r<=num_verts; r++) {
+		out.csr1[r] = n;
+	}
+
+	free(keys);
+	free(values);
+}
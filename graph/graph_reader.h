@@ -0,0 +1,121 @@
+/*
+	Graph readers header, graph_reader.h
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	A GraphReader parses one text format straight into CSR arrays,
+	which Graph then owns.  Readers:
+
+		AdjlistReader - the adjacency list, one row per vertex,
+			see Graph and util/edgelist_to_adjlist_driver.cpp
+		EdgelistReader - SNAP style edge lists, one edge per line,
+			u v or u v weight, separated by tabs or spaces,
+			with # comment lines.  Vertex ids are any unsigned
+			64-bit integers, relabeled to 0..n-1 in increasing
+			order of id, self loops dropped, and a repeated edge
+			keeps its smallest weight, as util/edgelist_to_adjlist
+			does.  Unless the ids were already 0..n-1, orig_ids
+			keeps the original id of each vertex
+		MatrixMarketReader - MatrixMarket coordinate files, .mtx,
+			of a square matrix; entry i j is the undirected edge
+			between vertices i-1 and j-1, and the values of an
+			integer matrix are the edge weights; real and
+			complex matrices are read as their pattern
+
+	Text is mapped, split into chunks at line starts, and parsed by
+	all threads.  Edges read from edge lists and MatrixMarket files
+	are packed into 64-bit keys, radix sorted and deduplicated in
+	parallel, see radix_sort.h.
+
+	choose_reader picks a reader for FORMAT_AUTO by the file's first
+	line, then by its extension, and otherwise takes it to be an
+	adjacency list, since an edge list line is also a valid row.
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#ifndef GRAPH_READER_H
+#define GRAPH_READER_H
+
+#include<string>
+using std::string;
+
+#include "graph_types.h"
+
+enum GraphFormat {
+	FORMAT_AUTO,
+	FORMAT_ADJLIST,
+	FORMAT_EDGELIST,
+	FORMAT_MATRIX_MARKET
+};
+
+/*
+	A graph in CSR format, weights NULL if unweighted,
+	and orig_ids NULL if vertices keep their ids
+*/
+struct CSRArrays {
+	int num_verts;
+	eid_t num_edges;
+	eid_t* csr1;
+	int* csr2;
+	int* weights;
+	uint64* orig_ids;
+};
+
+/*
+	A contiguous range of a text file, starting at a line,
+	with the lines and tokens counted by a first pass
+*/
+struct ParseChunk {
+	const char* begin;
+	const char* end;
+	long long num_lines;
+	long long num_items;
+	bool weighted;
+	long long first_line;
+	long long first_item;
+};
+
+class GraphReader {
+
+	public:
+		virtual ~GraphReader() {}
+		virtual int get_format() = 0;
+		virtual void read(string, CSRArrays&) = 0;
+
+};
+
+class AdjlistReader : public GraphReader {
+
+	public:
+		int get_format();
+		void read(string, CSRArrays&);
+
+};
+
+class EdgelistReader : public GraphReader {
+
+	public:
+		int get_format();
+		void read(string, CSRArrays&);
+
+};
+
+class MatrixMarketReader : public GraphReader {
+
+	public:
+		int get_format();
+		void read(string, CSRArrays&);
+
+};
+
+GraphReader* choose_reader(string, int);
+const char* format_name(int);
+
+/* shared by the readers */
+const char* map_text(string, size_t&);
+void unmap_text(const char*, size_t);
+int split_chunks(const char*, size_t, ParseChunk*&);
+void build_csr_from_edges(long long, int*, int*, int*, int, CSRArrays&);
+
+#endif
@@ -0,0 +1,51 @@
+/*
+	Graph index types header, graph_types.h
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	The widths of graph indices and path counts, fixed when
+	the program is built, so graphs that fit in 32-bit indices
+	keep the compact layout and only large builds pay for wider ones.
+
+		eid_t - edge offsets, csr1 and the number of directed edges.
+			int by default; long long with -DBC_WIDE_EDGES, for graphs
+			of more than 2^31-1 directed edges
+		sigma_t - shortest path counts in the Brandes engines.
+			double by default, exact to 2^53 paths and
+			approximate, never wrapping, beyond;
+			long double with -DBC_LONG_DOUBLE_PATHS
+		uint64 - original vertex ids, see graph_reader.h
+
+	Vertex ids stay int in every build: the all-pairs cost of
+	exact Brandes is out of reach long before 2^31 vertices,
+	while that many edges is not.
+
+	make betweenness_large builds with both wide types.
+	A binary graph records the width of its csr1, see graph_binary.h,
+	and is only mapped by a build of the same width.
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#ifndef GRAPH_TYPES_H
+#define GRAPH_TYPES_H
+
+#include<climits>
+
+typedef unsigned long long uint64;
+
+#ifdef BC_WIDE_EDGES
+typedef long long eid_t;
+#define EID_MAX LLONG_MAX
+#else
+typedef int eid_t;
+#define EID_MAX INT_MAX
+#endif
+
+#ifdef BC_LONG_DOUBLE_PATHS
+typedef long double sigma_t;
+#else
+typedef double sigma_t;
+#endif
+
+#endif
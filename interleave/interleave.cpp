@@ -0,0 +1,242 @@
+/*
+	Interleaved BFS implementation, interleave.cpp
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Several Brandes searches stepped round-robin by one thread,
+	with software prefetches ahead of each, see interleave.h
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "interleave.h"
+
+InterleavedBFS::InterleavedBFS(Graph &g, int width, bool use_prefetch) {
+	num_verts = g.get_num_verts();
+	csr1 = g.get_csr1();
+	csr2 = g.get_csr2();
+
+	num_lanes = width;
+	lanes = new InterleaveLane[num_lanes];
+	for(int l=0; l<num_lanes; l++) {
+		lanes[l].ws = new Workspace(num_verts);
+		lanes[l].src = -1;
+		lanes[l].phase = LANE_IDLE;
+		lanes[l].head = 0;
+		lanes[l].tail = 0;
+		lanes[l].next = -1;
+	}
+	prefetch = use_prefetch;
+
+	nodes_expanded = 0;
+	edges_examined = 0;
+}
+
+InterleavedBFS::~InterleavedBFS() {
+	for(int l=0; l<num_lanes; l++) {
+		delete lanes[l].ws;
+	}
+	delete [] lanes;
+}
+
+/* nodes stepped over, forward and backward, summed over runs */
+long long InterleavedBFS::get_nodes_expanded() {
+	return nodes_expanded;
+}
+
+/* rows of csr2 read, forward and backward, summed over runs */
+long long InterleavedBFS::get_edges_examined() {
+	return edges_examined;
+}
+
+/*
+	Run Brandes from each of the count sources, adding their
+	dependencies, times scale, into centrality, with atomic
+	updates if it is shared.  Up to num_lanes searches are in
+	flight, and a lane is refilled as soon as its search ends
+*/
+void InterleavedBFS::run(int* sources, int count, float* centrality, bool atomic, float scale) {
+
+	int given = 0;
+	int active = 0;
+	for(int l=0; l<num_lanes && given<count; l++) {
+		start(lanes[l], sources[given++]);
+		active++;
+	}
+
+	while( active > 0 ) {
+		for(int l=0; l<num_lanes; l++) {
+			InterleaveLane &lane = lanes[l];
+			if( lane.phase == LANE_FORWARD ) {
+				step_forward(lane);
+			} else if( lane.phase == LANE_BACKWARD ) {
+				step_backward(lane, centrality, atomic, scale);
+				if( lane.phase == LANE_IDLE ) {
+					if( given < count ) {
+						start(lane, sources[given++]);
+					} else {
+						active--;
+					}
+				}
+			}
+		}
+	}
+}
+
+/* begin a search from src in a lane, whose workspace is reset */
+void InterleavedBFS::start(InterleaveLane &lane, int src) {
+	Workspace* ws = lane.ws;
+	ws->get_dist()[src] = 0;
+	ws->get_num_paths()[src] = 1;
+	ws->get_queue()[0] = src;
+	lane.src = src;
+	lane.phase = LANE_FORWARD;
+	lane.head = 0;
+	lane.tail = 1;
+	lane.next = -1;
+}
+
+/* prefetch the start of node v's row of csr2 */
+void InterleavedBFS::prefetch_row(int v) {
+	__builtin_prefetch( &csr2[csr1[v]] );
+}
+
+/*
+	prefetch the dist of node v's neighbors, going backward
+	also their num_paths and delta; forward, num_paths is
+	read only for the neighbors on the next level
+*/
+void InterleavedBFS::prefetch_neighbors(InterleaveLane &lane, int v, bool backward) {
+	int* dist = lane.ws->get_dist();
+	sigma_t* num_paths = lane.ws->get_num_paths();
+	float* delta = lane.ws->get_delta();
+	eid_t offset = csr1[v];
+	int degree = csr1[v+1] - offset;
+	for(int j=0; j<degree; j++) {
+		int w = csr2[j+offset];
+		__builtin_prefetch( &dist[w] );
+		if( backward ) {
+			__builtin_prefetch( &num_paths[w] );
+			__builtin_prefetch( &delta[w] );
+		}
+	}
+}
+
+/*
+	Expand the next node of the lane's queue top-down, as in
+	brandes_bfs_source; nodes are appended in order of discovery,
+	so a node's distance gives the level it expands.
+	When the queue is exhausted the lane turns backward
+*/
+void InterleavedBFS::step_forward(InterleaveLane &lane) {
+
+	Workspace* ws = lane.ws;
+	int* queue = ws->get_queue();
+	int* dist = ws->get_dist();
+	sigma_t* num_paths = ws->get_num_paths();
+
+	if( lane.head == lane.tail ) {
+		ws->set_num_touched(lane.tail);
+		lane.phase = LANE_BACKWARD;
+		lane.next = lane.tail - 1;
+		return;
+	}
+
+	int head = lane.head;
+	if( prefetch ) {
+		if( head+3 < lane.tail ) {
+			__builtin_prefetch( &csr1[queue[head+3]] );
+		}
+		if( head+2 < lane.tail ) {
+			prefetch_row(queue[head+2]);
+		}
+		if( head+1 < lane.tail ) {
+			prefetch_neighbors(lane, queue[head+1], false);
+		}
+	}
+
+	int current_node = queue[head];
+	lane.head = head + 1;
+	int next_dist = dist[current_node] + 1;
+	eid_t offset = csr1[current_node];
+	int degree = csr1[current_node+1] - offset;
+	int tail = lane.tail;
+
+	for(int j=0; j<degree; j++) {
+		int neighbor = csr2[j+offset];
+		if( dist[neighbor] < 0 ) {
+			dist[neighbor] = next_dist;
+			queue[tail++] = neighbor;
+		}
+		if( dist[neighbor] == next_dist ) {
+			num_paths[neighbor] += num_paths[current_node];
+		}
+	}
+	lane.tail = tail;
+
+	nodes_expanded++;
+	edges_examined += degree;
+}
+
+/*
+	Accumulate the dependency of the lane's next node walking
+	the queue backwards, pulling from its children as in
+	brandes_bfs_source.  When the source is done the workspace
+	is reset and the lane is idle
+*/
+void InterleavedBFS::step_backward(InterleaveLane &lane, float* centrality, bool atomic, float scale) {
+
+	Workspace* ws = lane.ws;
+	int* queue = ws->get_queue();
+	int* dist = ws->get_dist();
+	sigma_t* num_paths = ws->get_num_paths();
+	float* delta = ws->get_delta();
+
+	if( lane.next < 0 ) {
+		ws->reset();
+		lane.phase = LANE_IDLE;
+		return;
+	}
+
+	int next = lane.next;
+	if( prefetch ) {
+		if( next-3 >= 0 ) {
+			__builtin_prefetch( &csr1[queue[next-3]] );
+		}
+		if( next-2 >= 0 ) {
+			prefetch_row(queue[next-2]);
+		}
+		if( next-1 >= 0 ) {
+			prefetch_neighbors(lane, queue[next-1], true);
+		}
+	}
+
+	int node = queue[next];
+	lane.next = next - 1;
+	int child_dist = dist[node] + 1;
+	eid_t offset = csr1[node];
+	int degree = csr1[node+1] - offset;
+	sigma_t node_paths = num_paths[node];
+	float sum = 0.0;
+	for(int k=0; k<degree; k++) {
+		int child = csr2[k+offset];
+		if( dist[child] == child_dist ) {
+			sum += node_paths / num_paths[child] * (1 + delta[child]);
+		}
+	}
+	delta[node] = sum;
+	if( node != lane.src ) {
+		if( atomic ) {
+			#pragma omp atomic
+			centrality[node] += sum*scale;
+		} else {
+			centrality[node] += sum*scale;
+		}
+	}
+
+	nodes_expanded++;
+	edges_examined += degree;
+}
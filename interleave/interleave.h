@@ -0,0 +1,101 @@
+/*
+	Interleaved BFS header, interleave.h
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Brandes on an unweighted graph, one thread running several
+	sources at once to hide the latency of memory.  On a graph
+	larger than the last level cache, nearly every neighbor a
+	search examines misses: its row of csr2, then its dist and
+	num_paths.  A single search can only look a node or two
+	ahead in its own queue, and not at all while its frontier is
+	small; independent searches have no such dependency.
+
+	Each source is a lane with its own Workspace, and a search is
+	a state machine that advances one node per step, forward
+	through the queue and then backward, as in brandes_bfs_source.
+	The thread steps the lanes round-robin, and before a step
+	expands a node, prefetches for the lane's next nodes in turn:
+	the csr1 entry of the node three ahead, the csr2 row of the
+	node two ahead, and the dist of the next node's neighbors,
+	with their num_paths and delta going backward, so the misses
+	of each lane resolve while the other lanes work.  A lane that finishes is refilled with
+	the next source of the batch.
+
+	Levels are expanded top-down only.  A bottom-up level scans
+	every node in order, which the hardware already prefetches.
+
+	Members:
+
+		lanes - the state of each lane: its Workspace, its source,
+		its phase, and its position in the queue
+
+		prefetch - whether to issue prefetches; without them,
+		interleaving alone is measured, see bench/prefetch_bench.cpp
+
+		nodes_expanded, edges_examined - counts over all runs,
+		forward and backward
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#ifndef INTERLEAVE_H
+#define INTERLEAVE_H
+
+#include "graph.h"
+#include "workspace.h"
+
+/*
+	default lanes per thread; each lane is a Workspace, so more
+	lanes also grow the memory in use, see bench/prefetch_bench.cpp
+	for the count that pays off on a machine
+*/
+#define INTERLEAVE_LANES 4
+
+enum LanePhase {
+	LANE_IDLE,
+	LANE_FORWARD,
+	LANE_BACKWARD
+};
+
+struct InterleaveLane {
+	Workspace* ws;
+	int src;
+	int phase;
+	int head;
+	int tail;
+	int next;
+};
+
+class InterleavedBFS {
+
+	public:
+		InterleavedBFS(Graph&, int, bool);
+		~InterleavedBFS();
+
+		void run(int*, int, float*, bool, float);
+
+		long long get_nodes_expanded();
+		long long get_edges_examined();
+
+	private:
+		void start(InterleaveLane&, int);
+		void step_forward(InterleaveLane&);
+		void step_backward(InterleaveLane&, float*, bool, float);
+		void prefetch_row(int);
+		void prefetch_neighbors(InterleaveLane&, int, bool);
+
+		int num_verts;
+		eid_t* csr1;
+		int* csr2;
+
+		InterleaveLane* lanes;
+		int num_lanes;
+		bool prefetch;
+
+		long long nodes_expanded;
+		long long edges_examined;
+
+};
+
+#endif
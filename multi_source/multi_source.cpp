@@ -0,0 +1,292 @@
+/*
+	Bit-parallel multi-source BFS implementation, multi_source.cpp
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Path counts and dependencies of a batch of sources,
+	sharing each read of a row across the batch, see multi_source.h
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "multi_source.h"
+
+MultiSourceBFS::MultiSourceBFS(Graph &g) {
+	num_verts = g.get_num_verts();
+	csr1 = g.get_csr1();
+	csr2 = g.get_csr2();
+
+	size_t words = size_t(num_verts) * MS_WORDS;
+	size_t lanes = size_t(num_verts) * MS_LANES;
+	seen = new uint64[words];
+	level_mask = new uint64[words];
+	reach = new uint64[words];
+	num_paths = new sigma_t[lanes];
+	delta = new float[lanes];
+	memset( seen, 0, words*sizeof(uint64) );
+	memset( level_mask, 0, words*sizeof(uint64) );
+	memset( reach, 0, words*sizeof(uint64) );
+	for(size_t i=0; i<lanes; i++) {
+		num_paths[i] = 0;
+		delta[i] = 0.0;
+	}
+
+	touched = new int[num_verts];
+	num_touched = 0;
+
+	// a node is recorded once for each level it is reached on
+	records_capacity = num_verts + MS_LANES;
+	record_node = (int*)malloc( records_capacity*sizeof(int) );
+	record_mask = (uint64*)malloc( size_t(records_capacity)*MS_WORDS*sizeof(uint64) );
+	level_start = new int[num_verts+2];
+	if( record_node == NULL || record_mask == NULL ) {
+		printf("bad MultiSourceBFS malloc of records: %d\n", records_capacity);
+		exit(1);
+	}
+	num_records = 0;
+	num_levels = 0;
+
+	edges_read = 0;
+	edges_traversed = 0;
+}
+
+MultiSourceBFS::~MultiSourceBFS() {
+	delete [] seen;
+	delete [] level_mask;
+	delete [] reach;
+	delete [] num_paths;
+	delete [] delta;
+	delete [] touched;
+	free(record_node);
+	free(record_mask);
+	delete [] level_start;
+}
+
+/* memory per node of one MultiSourceBFS, for choosing an engine */
+size_t MultiSourceBFS::bytes_per_node() {
+	return 3*MS_WORDS*sizeof(uint64) + MS_LANES*(sizeof(sigma_t) + sizeof(float))
+		+ 2*sizeof(int) + MS_WORDS*sizeof(uint64) + sizeof(int);
+}
+
+/* rows of csr2 read, summed over batches */
+long long MultiSourceBFS::get_edges_read() {
+	return edges_read;
+}
+
+/* rows of csr2 read times the lanes sharing each read */
+long long MultiSourceBFS::get_edges_traversed() {
+	return edges_traversed;
+}
+
+/* the number of lanes set in a bitset */
+static inline int count_lanes(uint64* mask) {
+	int count = 0;
+	for(int k=0; k<MS_WORDS; k++) {
+		count += __builtin_popcountll(mask[k]);
+	}
+	return count;
+}
+
+/* record node v as reached by the lanes of mask on the current level */
+void MultiSourceBFS::add_record(int v, uint64* mask) {
+	if( num_records == records_capacity ) {
+		records_capacity *= 2;
+		record_node = (int*)realloc( record_node, records_capacity*sizeof(int) );
+		record_mask = (uint64*)realloc( record_mask, size_t(records_capacity)*MS_WORDS*sizeof(uint64) );
+		if( record_node == NULL || record_mask == NULL ) {
+			printf("bad MultiSourceBFS realloc of records: %d\n", records_capacity);
+			exit(1);
+		}
+	}
+	record_node[num_records] = v;
+	memcpy( &record_mask[size_t(num_records)*MS_WORDS], mask, MS_WORDS*sizeof(uint64) );
+	num_records++;
+}
+
+/*
+	Run Brandes from the num_sources distinct nodes of sources,
+	at most MS_LANES, adding their dependencies, times scale,
+	into centrality, with atomic updates if it is shared
+*/
+void MultiSourceBFS::run(int* sources, int num_sources, float* centrality, bool atomic, float scale) {
+
+	num_records = 0;
+	level_start[0] = 0;
+	for(int lane=0; lane<num_sources; lane++) {
+		int s = sources[lane];
+		uint64* mask = &level_mask[size_t(s)*MS_WORDS];
+		mask[lane/64] |= 1ULL << (lane%64);
+		seen[size_t(s)*MS_WORDS + lane/64] |= 1ULL << (lane%64);
+		num_paths[size_t(s)*MS_LANES + lane] = 1;
+		add_record(s, mask);
+	}
+	level_start[1] = num_records;
+	num_levels = 1;
+
+	forward();
+	backward(centrality, atomic, scale);
+	reset();
+}
+
+/*
+	The forward pass.  Each node v of a level pushes, to each
+	neighbor w, the lanes of v on the level that w has not seen;
+	in those lanes w is on the next level, and adds the path
+	counts of v.  The lanes reaching w collect in reach[w] until
+	the level is done, then become w's record and level_mask
+*/
+void MultiSourceBFS::forward() {
+
+	for(int l=0; level_start[l+1] > level_start[l]; l++) {
+
+		num_touched = 0;
+		for(int r=level_start[l]; r<level_start[l+1]; r++) {
+			int v = record_node[r];
+			uint64* v_mask = &level_mask[size_t(v)*MS_WORDS];
+			sigma_t* v_paths = &num_paths[size_t(v)*MS_LANES];
+			eid_t offset = csr1[v];
+			int degree = csr1[v+1] - offset;
+			edges_read += degree;
+			edges_traversed += (long long)degree * count_lanes(v_mask);
+
+			for(int j=0; j<degree; j++) {
+				int w = csr2[j+offset];
+				uint64* w_seen = &seen[size_t(w)*MS_WORDS];
+				uint64* w_reach = &reach[size_t(w)*MS_WORDS];
+				uint64 lanes[MS_WORDS];
+				uint64 any = 0;
+				uint64 reached = 0;
+				for(int k=0; k<MS_WORDS; k++) {
+					lanes[k] = v_mask[k] & ~w_seen[k];
+					any |= lanes[k];
+					reached |= w_reach[k];
+				}
+				if( any == 0 ) {
+					continue;
+				}
+				if( reached == 0 ) {
+					touched[num_touched++] = w;
+				}
+				sigma_t* w_paths = &num_paths[size_t(w)*MS_LANES];
+				for(int k=0; k<MS_WORDS; k++) {
+					w_reach[k] |= lanes[k];
+					uint64 bits = lanes[k];
+					while( bits ) {
+						int lane = 64*k + __builtin_ctzll(bits);
+						bits &= bits - 1;
+						w_paths[lane] += v_paths[lane];
+					}
+				}
+			}
+		}
+
+		// the next level replaces this one
+		for(int r=level_start[l]; r<level_start[l+1]; r++) {
+			memset( &level_mask[size_t(record_node[r])*MS_WORDS], 0, MS_WORDS*sizeof(uint64) );
+		}
+		for(int t=0; t<num_touched; t++) {
+			int w = touched[t];
+			uint64* w_reach = &reach[size_t(w)*MS_WORDS];
+			uint64* w_seen = &seen[size_t(w)*MS_WORDS];
+			uint64* w_mask = &level_mask[size_t(w)*MS_WORDS];
+			for(int k=0; k<MS_WORDS; k++) {
+				w_seen[k] |= w_reach[k];
+				w_mask[k] = w_reach[k];
+				w_reach[k] = 0;
+			}
+			add_record(w, w_mask);
+		}
+		level_start[l+2] = num_records;
+		num_levels = l+2;
+	}
+}
+
+/*
+	The backward pass, deepest level first.  level_mask holds the
+	lanes of the level below the one being accumulated, so a
+	neighbor w of v is a child in the lanes v's record shares
+	with level_mask[w].  The sources, alone on level 0,
+	add no centrality
+*/
+void MultiSourceBFS::backward(float* centrality, bool atomic, float scale) {
+
+	for(int l=num_levels-2; l>=0; l--) {
+
+		for(int r=level_start[l]; r<level_start[l+1]; r++) {
+			int v = record_node[r];
+			uint64* v_mask = &record_mask[size_t(r)*MS_WORDS];
+			sigma_t* v_paths = &num_paths[size_t(v)*MS_LANES];
+			float* v_delta = &delta[size_t(v)*MS_LANES];
+			eid_t offset = csr1[v];
+			int degree = csr1[v+1] - offset;
+			edges_read += degree;
+			edges_traversed += (long long)degree * count_lanes(v_mask);
+
+			for(int j=0; j<degree; j++) {
+				int w = csr2[j+offset];
+				uint64* w_mask = &level_mask[size_t(w)*MS_WORDS];
+				sigma_t* w_paths = &num_paths[size_t(w)*MS_LANES];
+				float* w_delta = &delta[size_t(w)*MS_LANES];
+				for(int k=0; k<MS_WORDS; k++) {
+					uint64 bits = v_mask[k] & w_mask[k];
+					while( bits ) {
+						int lane = 64*k + __builtin_ctzll(bits);
+						bits &= bits - 1;
+						v_delta[lane] += v_paths[lane] / w_paths[lane] * (1 + w_delta[lane]);
+					}
+				}
+			}
+
+			if( l > 0 ) {
+				float sum = 0.0;
+				for(int k=0; k<MS_WORDS; k++) {
+					uint64 bits = v_mask[k];
+					while( bits ) {
+						int lane = 64*k + __builtin_ctzll(bits);
+						bits &= bits - 1;
+						sum += v_delta[lane];
+					}
+				}
+				if( atomic ) {
+					#pragma omp atomic
+					centrality[v] += sum*scale;
+				} else {
+					centrality[v] += sum*scale;
+				}
+			}
+		}
+
+		// level l becomes the level below for level l-1
+		for(int r=level_start[l+1]; r<level_start[l+2]; r++) {
+			memset( &level_mask[size_t(record_node[r])*MS_WORDS], 0, MS_WORDS*sizeof(uint64) );
+		}
+		for(int r=level_start[l]; r<level_start[l+1]; r++) {
+			memcpy( &level_mask[size_t(record_node[r])*MS_WORDS], &record_mask[size_t(r)*MS_WORDS], MS_WORDS*sizeof(uint64) );
+		}
+	}
+}
+
+/* restore the nodes of every record, the nodes the batch reached */
+void MultiSourceBFS::reset() {
+	for(int r=0; r<num_records; r++) {
+		int v = record_node[r];
+		memset( &seen[size_t(v)*MS_WORDS], 0, MS_WORDS*sizeof(uint64) );
+		memset( &level_mask[size_t(v)*MS_WORDS], 0, MS_WORDS*sizeof(uint64) );
+		uint64* mask = &record_mask[size_t(r)*MS_WORDS];
+		for(int k=0; k<MS_WORDS; k++) {
+			uint64 bits = mask[k];
+			while( bits ) {
+				int lane = 64*k + __builtin_ctzll(bits);
+				bits &= bits - 1;
+				num_paths[size_t(v)*MS_LANES + lane] = 0;
+				delta[size_t(v)*MS_LANES + lane] = 0.0;
+			}
+		}
+	}
+	num_records = 0;
+	num_levels = 0;
+}
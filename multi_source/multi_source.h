@@ -0,0 +1,101 @@
+/*
+	Bit-parallel multi-source BFS header, multi_source.h
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Brandes on an unweighted graph for a batch of up to MS_LANES
+	sources at once.  Each source is a lane, and the per-node
+	search state of every lane is packed into bitsets, so a row
+	of csr2 is read once for all of the lanes that reach the node
+	at the same level, rather than once per source.
+
+	The search runs level by level.  Expanding a level, each node
+	on it pushes its lanes at that level to its neighbors that
+	those lanes have not seen, with the path counts of each lane.
+	Every node reached at a level is recorded with the lanes that
+	reached it there, so the backward pass walks the records in
+	reverse, each node pulling the dependency of its children lane
+	by lane from the neighbors whose lanes sit one level further.
+
+	Members:
+
+		seen - per node, the lanes that have reached it
+
+		level_mask - per node, the lanes for which it is on the
+		level being expanded, or in the backward pass, on the
+		level below
+
+		reach - per node, the lanes reaching it on the next level
+
+		num_paths, delta - per node, the path count and
+		dependency of every lane, MS_LANES entries per node
+
+		records - the nodes of each level, with their lanes
+		there, level_start[l] the first record of level l
+
+	A bitset is MS_WORDS 64-bit words; MS_LANES is 64 by default,
+	and 256 built with -DMS_WORDS=4, whose word loops the
+	compiler may vectorize.
+	Like a Workspace, a MultiSourceBFS is allocated once per
+	thread and only the nodes a batch reached are reset after it.
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#ifndef MULTI_SOURCE_H
+#define MULTI_SOURCE_H
+
+#include <cstddef>
+
+#include "graph.h"
+
+#ifndef MS_WORDS
+#define MS_WORDS 1
+#endif
+#define MS_LANES (64*MS_WORDS)
+
+class MultiSourceBFS {
+
+	public:
+		MultiSourceBFS(Graph&);
+		~MultiSourceBFS();
+
+		void run(int*, int, float*, bool, float);
+
+		long long get_edges_read();
+		long long get_edges_traversed();
+
+		static size_t bytes_per_node();
+
+	private:
+		void forward();
+		void backward(float*, bool, float);
+		void reset();
+		void add_record(int, uint64*);
+
+		int num_verts;
+		eid_t* csr1;
+		int* csr2;
+
+		uint64* seen;
+		uint64* level_mask;
+		uint64* reach;
+		sigma_t* num_paths;
+		float* delta;
+
+		int* touched;
+		int num_touched;
+
+		int* record_node;
+		uint64* record_mask;
+		int num_records;
+		int records_capacity;
+		int* level_start;
+		int num_levels;
+
+		long long edges_read;
+		long long edges_traversed;
+
+};
+
+#endif
@@ -0,0 +1,216 @@
+/*
+	Degree-1 pruning implementation, prune.cpp
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Strip pendant trees, count their paths analytically,
+	and search from the remaining nodes, see prune.h
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <omp.h>
+
+#include "prune.h"
+#include "workspace.h"
+#include "radix_heap.h"
+#include "reduction.h"
+
+/*
+	The pairs of a component of comp_size nodes whose paths
+	pass through a node of reach r, whose subtrees' reaches
+	have squares summing to sq, other than those between
+	remaining nodes, see prune.h
+*/
+static inline double tree_pairs(long long r, long long sq, long long comp_size) {
+	return 0.5 * double( (r-1)*(r-1) - sq ) + double(r-1) * double(comp_size - r);
+}
+
+/*
+	Strip nodes of degree 1 until none are left, marking them
+	removed, and set reach, the nodes each remaining node stands
+	for, and the centrality of every node from paths in the trees.
+	Returns the number of nodes removed
+*/
+static int prune_trees(Graph &g, int* reach, bool* removed, float* centrality) {
+
+	int num_verts = g.get_num_verts();
+	eid_t* csr1 = g.get_csr1();
+	int* csr2 = g.get_csr2();
+
+	int* degree = new int[num_verts];
+	long long* sq = new long long[num_verts];
+	int* stack = new int[num_verts];
+	int top = 0;
+	for(int v=0; v<num_verts; v++) {
+		degree[v] = g.get_degree(v);
+		reach[v] = 1;
+		sq[v] = 0;
+		removed[v] = false;
+		if( degree[v] == 1 ) {
+			stack[top++] = v;
+		}
+	}
+
+	int num_removed = 0;
+	while( top > 0 ) {
+		int u = stack[--top];
+		if( removed[u] || degree[u] != 1 ) {
+			continue;
+		}
+		// the one neighbor left, unless u is the last node of a tree
+		int v = -1;
+		for(eid_t j=csr1[u]; j<csr1[u+1]; j++) {
+			if( !removed[csr2[j]] && csr2[j] != u ) {
+				v = csr2[j];
+				break;
+			}
+		}
+		if( v < 0 ) {
+			continue;
+		}
+		centrality[u] = float( tree_pairs(reach[u], sq[u], g.get_component_size(g.get_component(u))) );
+		removed[u] = true;
+		num_removed++;
+		reach[v] += reach[u];
+		sq[v] += (long long)reach[u] * reach[u];
+		degree[u] = 0;
+		degree[v]--;
+		if( degree[v] == 1 ) {
+			stack[top++] = v;
+		}
+	}
+
+	for(int v=0; v<num_verts; v++) {
+		if( !removed[v] ) {
+			centrality[v] = float( tree_pairs(reach[v], sq[v], g.get_component_size(g.get_component(v))) );
+		}
+	}
+
+	delete [] degree;
+	delete [] sq;
+	delete [] stack;
+	return num_removed;
+}
+
+/*
+	The graph of the nodes not removed, numbered in order,
+	keep[i] the node of g that is node i, with the edges
+	between them and their weights
+*/
+static Graph* remaining_graph(Graph &g, bool* removed, int* keep, int num_keep) {
+
+	int num_verts = g.get_num_verts();
+	eid_t* csr1 = g.get_csr1();
+	int* csr2 = g.get_csr2();
+	int* weights = g.get_weights();
+
+	int* renumber = new int[num_verts];
+	for(int v=0, i=0; v<num_verts; v++) {
+		renumber[v] = removed[v] ? -1 : i++;
+	}
+
+	eid_t* row_offsets = new eid_t[num_keep+1];
+	row_offsets[0] = 0;
+	for(int i=0; i<num_keep; i++) {
+		int v = keep[i];
+		eid_t count = 0;
+		for(eid_t j=csr1[v]; j<csr1[v+1]; j++) {
+			if( !removed[csr2[j]] ) {
+				count++;
+			}
+		}
+		row_offsets[i+1] = row_offsets[i] + count;
+	}
+
+	eid_t num_edges = row_offsets[num_keep];
+	int* neighbors = new int[num_edges];
+	int* edge_weights = (weights == NULL) ? NULL : new int[num_edges];
+	#pragma omp parallel for schedule(dynamic, 64)
+	for(int i=0; i<num_keep; i++) {
+		int v = keep[i];
+		eid_t k = row_offsets[i];
+		for(eid_t j=csr1[v]; j<csr1[v+1]; j++) {
+			if( !removed[csr2[j]] ) {
+				neighbors[k] = renumber[csr2[j]];
+				if( weights != NULL ) {
+					edge_weights[k] = weights[j];
+				}
+				k++;
+			}
+		}
+	}
+
+	delete [] renumber;
+	return new Graph(num_keep, num_edges, row_offsets, neighbors, edge_weights, g.get_filename());
+}
+
+/*
+	Exact betweenness with the pendant trees pruned, see prune.h.
+	The remaining graph is searched with the Dijkstra engine if
+	the exact computation would use Dijkstra or delta-stepping,
+	and otherwise with the BFS engine, a Workspace per thread.
+	Returns the number of sources searched
+*/
+int brandes_pruned(Graph &g, float* centrality, BrandesOptions &opts) {
+
+	int num_verts = g.get_num_verts();
+	int* reach = new int[num_verts];
+	bool* removed = new bool[num_verts];
+	int num_removed = prune_trees(g, reach, removed, centrality);
+
+	int num_keep = num_verts - num_removed;
+	int* keep = new int[num_keep];
+	int* keep_reach = new int[num_keep];
+	for(int v=0, i=0; v<num_verts; v++) {
+		if( !removed[v] ) {
+			keep[i] = v;
+			keep_reach[i] = reach[v];
+			i++;
+		}
+	}
+	printf("Pruned %d of %d vertices, in trees hanging from the remaining %d\n", num_removed, num_verts, num_keep);
+
+	Graph* core = remaining_graph(g, removed, keep, num_keep);
+	int engine = choose_engine(g, opts);
+	bool weighted = ( engine == ENGINE_DIJKSTRA || engine == ENGINE_DELTA_STEPPING );
+
+	float* core_centrality = new float[num_keep];
+	for(int i=0; i<num_keep; i++) {
+		core_centrality[i] = 0.0;
+	}
+	CentralityReduction red(core_centrality, num_keep, opts.reduce_mode, opts.mem_budget_mb);
+
+	#pragma omp parallel
+	{
+		Workspace ws(num_keep);
+		RadixHeap heap;
+		float* acc = red.thread_begin();
+		bool atomic = red.is_atomic();
+
+		#pragma omp for schedule(dynamic, 8)
+		for(int i=0; i<num_keep; i++) {
+			if( weighted ) {
+				brandes_dijkstra_source(*core, ws, heap, i, acc, atomic, 0.5, false, keep_reach, NULL);
+			} else {
+				brandes_bfs_source(*core, ws, i, acc, atomic, 0.5, false, opts.bfs_direction, keep_reach, NULL);
+			}
+		}
+
+		red.thread_end();
+	}
+
+	for(int i=0; i<num_keep; i++) {
+		centrality[keep[i]] += core_centrality[i];
+	}
+
+	delete core;
+	delete [] reach;
+	delete [] removed;
+	delete [] keep;
+	delete [] keep_reach;
+	delete [] core_centrality;
+	return num_keep;
+}
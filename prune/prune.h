@@ -0,0 +1,42 @@
+/*
+	Degree-1 pruning header, prune.h
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Exact betweenness with the pendant trees of a graph folded
+	into the nodes they hang from, so no search starts in them
+	or walks through them.
+
+	Nodes of degree 1 are stripped repeatedly, each adding its
+	reach, itself and the tree it carried, to the neighbor it
+	hung from, until only the 2-core and the roots of trees are
+	left.  A tree edge is a bridge, so every shortest path
+	leaving a node's tree passes through the node, and a node u
+	of reach r in a connected component of N nodes, whose
+	subtrees have reaches r_1, r_2, ..., lies on the paths
+	between
+
+		pairs in different subtrees:  ((r-1)^2 - sum r_i^2) / 2
+		its trees and the rest:       (r-1) (N - r)
+
+	which are added analytically.  Paths between the remaining
+	nodes a and b, weighted reach[a] times reach[b] pairs, are
+	counted by brandes_bfs_source or brandes_dijkstra_source,
+	see brandes.h, on the graph of the remaining nodes, one
+	source per remaining node.
+
+	The result matches the exact engines, while searching from
+	only the remaining nodes, over only their edges.
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#ifndef PRUNE_H
+#define PRUNE_H
+
+#include "graph.h"
+#include "brandes.h"
+
+int brandes_pruned(Graph&, float*, BrandesOptions&);
+
+#endif
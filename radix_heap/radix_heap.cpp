@@ -0,0 +1,127 @@
+/*
+	Radix heap implementation, radix_heap.cpp
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Monotone priority queue for integer distances,
+	see radix_heap.h
+
+	This software is distributed under 
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#include <stdio.h>
+#include <cstdlib>
+
+#include "radix_heap.h"
+
+RadixHeap::RadixHeap() {
+	for(int i=0; i<NUM_BUCKETS; i++) {
+		bucket_size[i] = 0;
+		bucket_capacity[i] = 16;
+		buckets[i] = (RH_elem*)malloc( bucket_capacity[i]*sizeof(RH_elem) );
+		if(buckets[i] == NULL) {
+			printf("bad initialization of RadixHeap\n");
+			exit(1);
+		}
+	}
+	last = 0;
+	size = 0;
+}
+
+RadixHeap::~RadixHeap() {
+	for(int i=0; i<NUM_BUCKETS; i++) {
+		free(buckets[i]);
+	}
+}
+
+/*
+	bucket of a distance: 0 if equal to last,
+	otherwise 1 + the index of the highest differing bit
+*/
+int RadixHeap::bucket_index(unsigned int dist) {
+	unsigned int diff = dist ^ last;
+	if( diff == 0 ) {
+		return 0;
+	}
+	return 32 - __builtin_clz(diff);
+}
+
+/* add an element to the end of a bucket, doubling it when full */
+void RadixHeap::append(int b, RH_elem e) {
+	if( bucket_size[b] == bucket_capacity[b] ) {
+		bucket_capacity[b] *= 2;
+		buckets[b] = (RH_elem*)realloc( buckets[b], bucket_capacity[b]*sizeof(RH_elem) );
+		if(buckets[b] == NULL) {
+			printf("bad RadixHeap realloc of capacity: %d\n", bucket_capacity[b]);
+			exit(1);
+		}
+	}
+	buckets[b][bucket_size[b]] = e;
+	bucket_size[b]++;
+}
+
+/*
+	insert a node with a distance,
+	which must be no smaller than the last popped distance
+*/
+void RadixHeap::push(int node, unsigned int dist) {
+	RH_elem e;
+	e.node = node;
+	e.dist = dist;
+	append( bucket_index(dist), e );
+	size++;
+}
+
+/*
+	Move the lowest non-empty bucket into lower buckets,
+	after raising last to the bucket's minimum distance
+*/
+void RadixHeap::redistribute() {
+	int b = 1;
+	while( bucket_size[b] == 0 ) {
+		b++;
+	}
+
+	unsigned int min = buckets[b][0].dist;
+	for(int i=1; i<bucket_size[b]; i++) {
+		if( buckets[b][i].dist < min ) {
+			min = buckets[b][i].dist;
+		}
+	}
+	last = min;
+
+	int old_size = bucket_size[b];
+	bucket_size[b] = 0;
+	for(int i=0; i<old_size; i++) {
+		RH_elem e = buckets[b][i];
+		append( bucket_index(e.dist), e );
+	}
+}
+
+/* remove and return an element of minimum distance */
+RH_elem RadixHeap::pop_min() {
+	if( bucket_size[0] == 0 ) {
+		redistribute();
+	}
+	bucket_size[0]--;
+	size--;
+	return buckets[0][bucket_size[0]];
+}
+
+bool RadixHeap::is_empty() {
+	if(size == 0) return true;
+	else return false;
+}
+
+int RadixHeap::get_size() {
+	return size;
+}
+
+/* empty the heap and restart distances at 0, keeping capacity */
+void RadixHeap::clear() {
+	for(int i=0; i<NUM_BUCKETS; i++) {
+		bucket_size[i] = 0;
+	}
+	last = 0;
+	size = 0;
+}
@@ -0,0 +1,71 @@
+/*
+	Radix heap header, radix_heap.h
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	A monotone priority queue of (node, distance) pairs,
+	for Dijkstra's algorithm with non-negative integer weights.
+
+	Distances popped from a radix heap never decrease,
+	so it keeps the last popped distance, last,
+	and stores each element in the bucket given by the
+	highest bit in which its distance differs from last.
+	Bucket 0 holds elements equal to last.
+	When bucket 0 is empty, the lowest non-empty bucket
+	is redistributed, and each element moves to a
+	strictly lower bucket, so every element is moved at most
+	32 times over its life: O(log C) amortized per operation.
+
+	There is no decrease-key: push a node again with its
+	smaller distance, and skip popped elements whose distance
+	no longer matches the node's current distance.
+
+	Members:
+
+		buckets - NUM_BUCKETS growable arrays of RH_elems
+
+		bucket_size, bucket_capacity - fill and capacity of each bucket
+
+		last - the distance most recently popped
+
+		size - the number of elements in the heap
+
+	This software is distributed under 
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#ifndef RADIX_HEAP_H
+#define RADIX_HEAP_H
+
+#define NUM_BUCKETS 33
+
+struct RH_elem {
+	int node;
+	unsigned int dist;
+};
+
+class RadixHeap {
+
+	public:
+		RadixHeap();
+		~RadixHeap();
+
+		void push(int, unsigned int);
+		RH_elem pop_min();
+		bool is_empty();
+		int get_size();
+		void clear();
+
+	private:
+		int bucket_index(unsigned int);
+		void append(int, RH_elem);
+		void redistribute();
+
+		RH_elem* buckets[NUM_BUCKETS];
+		int bucket_size[NUM_BUCKETS];
+		int bucket_capacity[NUM_BUCKETS];
+		unsigned int last;
+		int size;
+
+};
+
+#endif
@@ -0,0 +1,198 @@
+/*
+	Parallel radix sort implementation, radix_sort.cpp
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	LSD radix sort of 64-bit keys, see radix_sort.h
+
+	This software is distributed under 
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#include <stdio.h>
+#include <cstdlib>
+#include <omp.h>
+
+#include "radix_sort.h"
+
+#define RADIX_BITS 8
+#define RADIX_SIZE (1 << RADIX_BITS)
+
+/*
+	Sort keys[0..n) ascending, moving values with them.
+	values may be NULL
+*/
+void radix_sort(uint64* keys, int* values, long long n) {
+
+	if( n < 2 ) {
+		return;
+	}
+
+	uint64 all_bits = 0;
+	#pragma omp parallel for reduction(|:all_bits)
+	for(long long i=0; i<n; i++) {
+		all_bits |= keys[i];
+	}
+	int num_passes = 0;
+	while( num_passes*RADIX_BITS < 64 && (all_bits >> (num_passes*RADIX_BITS)) != 0 ) {
+		num_passes++;
+	}
+
+	uint64* key_buf = (uint64*)malloc( n*sizeof(uint64) );
+	int* value_buf = (values != NULL) ? (int*)malloc( n*sizeof(int) ) : NULL;
+	if( key_buf == NULL || (values != NULL && value_buf == NULL) ) {
+		printf("bad radix_sort malloc: %lld keys\n", n);
+		exit(1);
+	}
+
+	int num_threads = omp_get_max_threads();
+	long long* counts = new long long[ (long long)num_threads * RADIX_SIZE ];
+
+	uint64* src_keys = keys;
+	uint64* dst_keys = key_buf;
+	int* src_values = values;
+	int* dst_values = value_buf;
+
+	for(int pass=0; pass<num_passes; pass++) {
+		int shift = pass * RADIX_BITS;
+
+		#pragma omp parallel num_threads(num_threads)
+		{
+			int tid = omp_get_thread_num();
+			int threads = omp_get_num_threads();
+			long long begin = n * tid / threads;
+			long long end = n * (tid+1) / threads;
+			long long* my_counts = counts + (long long)tid * RADIX_SIZE;
+
+			for(int d=0; d<RADIX_SIZE; d++) {
+				my_counts[d] = 0;
+			}
+			for(long long i=begin; i<end; i++) {
+				my_counts[ (src_keys[i] >> shift) & (RADIX_SIZE-1) ]++;
+			}
+			#pragma omp barrier
+
+			// exclusive prefix sum, digit major, thread minor
+			#pragma omp single
+			{
+				long long offset = 0;
+				for(int d=0; d<RADIX_SIZE; d++) {
+					for(int t=0; t<threads; t++) {
+						long long c = counts[(long long)t*RADIX_SIZE + d];
+						counts[(long long)t*RADIX_SIZE + d] = offset;
+						offset += c;
+					}
+				}
+			}
+
+			for(long long i=begin; i<end; i++) {
+				long long pos = my_counts[ (src_keys[i] >> shift) & (RADIX_SIZE-1) ]++;
+				dst_keys[pos] = src_keys[i];
+				if( src_values != NULL ) {
+					dst_values[pos] = src_values[i];
+				}
+			}
+		}
+
+		uint64* tmp_keys = src_keys;
+		src_keys = dst_keys;
+		dst_keys = tmp_keys;
+		int* tmp_values = src_values;
+		src_values = dst_values;
+		dst_values = tmp_values;
+	}
+
+	// an odd number of passes leaves the result in the buffers
+	if( src_keys != keys ) {
+		#pragma omp parallel for
+		for(long long i=0; i<n; i++) {
+			keys[i] = src_keys[i];
+			if( values != NULL ) {
+				values[i] = src_values[i];
+			}
+		}
+	}
+
+	delete [] counts;
+	free(key_buf);
+	free(value_buf);
+}
+
+/*
+	Remove repeated keys from sorted keys[0..n), keeping the
+	smallest value of each run.  values may be NULL.
+	Each thread counts the runs that start in its block,
+	a prefix sum over threads places them, and each run is
+	then copied out by the thread its first key belongs to.
+	Returns the number of distinct keys
+*/
+long long unique_sorted(uint64* keys, int* values, long long n) {
+
+	if( n < 2 ) {
+		return n;
+	}
+
+	uint64* key_buf = (uint64*)malloc( n*sizeof(uint64) );
+	int* value_buf = (values != NULL) ? (int*)malloc( n*sizeof(int) ) : NULL;
+	if( key_buf == NULL || (values != NULL && value_buf == NULL) ) {
+		printf("bad unique_sorted malloc: %lld keys\n", n);
+		exit(1);
+	}
+
+	int num_threads = omp_get_max_threads();
+	long long* offsets = new long long[num_threads+1];
+	long long count = 0;
+
+	#pragma omp parallel num_threads(num_threads)
+	{
+		int tid = omp_get_thread_num();
+		int threads = omp_get_num_threads();
+		long long begin = n * tid / threads;
+		long long end = n * (tid+1) / threads;
+
+		long long runs = 0;
+		for(long long i=begin; i<end; i++) {
+			if( i == 0 || keys[i] != keys[i-1] ) runs++;
+		}
+		offsets[tid+1] = runs;
+		#pragma omp barrier
+
+		#pragma omp single
+		{
+			offsets[0] = 0;
+			for(int t=0; t<threads; t++) {
+				offsets[t+1] += offsets[t];
+			}
+			count = offsets[threads];
+		}
+
+		long long pos = offsets[tid];
+		for(long long i=begin; i<end; i++) {
+			if( i > 0 && keys[i] == keys[i-1] ) {
+				continue;
+			}
+			key_buf[pos] = keys[i];
+			if( values != NULL ) {
+				int min_value = values[i];
+				for(long long j=i+1; j<n && keys[j] == keys[i]; j++) {
+					if( values[j] < min_value ) min_value = values[j];
+				}
+				value_buf[pos] = min_value;
+			}
+			pos++;
+		}
+		#pragma omp barrier
+
+		#pragma omp for
+		for(long long i=0; i<count; i++) {
+			keys[i] = key_buf[i];
+			if( values != NULL ) {
+				values[i] = value_buf[i];
+			}
+		}
+	}
+
+	delete [] offsets;
+	free(key_buf);
+	free(value_buf);
+	return count;
+}
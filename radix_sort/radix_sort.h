@@ -0,0 +1,30 @@
+/*
+	Parallel radix sort header, radix_sort.h
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Sorts 64-bit unsigned keys, each with an optional int value,
+	with a least significant digit radix sort, 8 bits per pass.
+	Passes above the highest set bit of any key are skipped,
+	so keys packed from two 32-bit ids take at most 8 passes.
+
+	Each pass is split across OpenMP threads: every thread counts
+	the digits of its own block of keys, a prefix sum over
+	(digit, thread) gives every thread its own output offsets,
+	and each thread scatters its block in order.  The sort is
+	stable, so equal keys keep the order of their values.
+
+	Used to build CSR from edge lists, in Graph and the util converter.
+
+	This software is distributed under 
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+typedef unsigned long long uint64;
+
+void radix_sort(uint64*, int*, long long);
+long long unique_sorted(uint64*, int*, long long);
+
+#endif
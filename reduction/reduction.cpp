@@ -0,0 +1,102 @@
+/*
+	Centrality reduction implementation, reduction.cpp
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Thread-private accumulators merged in parallel,
+	or atomic updates when the private arrays do not fit
+
+	This software is distributed under 
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#include <omp.h>
+#include <cstdlib>
+
+#include "reduction.h"
+
+/*
+	Create a reduction into centrality, for the number of
+	threads the next parallel region will use.
+	mem_budget_mb bounds the private arrays in REDUCE_AUTO
+*/
+CentralityReduction::CentralityReduction(float* cent, int sz, int requested_mode, long mem_budget_mb) {
+	centrality = cent;
+	num_verts = sz;
+	num_threads = omp_get_max_threads();
+	mode = choose_mode(requested_mode, num_verts, num_threads, mem_budget_mb);
+	local = new float*[num_threads];
+	for(int i=0; i<num_threads; i++) {
+		local[i] = NULL;
+	}
+}
+
+CentralityReduction::~CentralityReduction() {
+	delete [] local;
+}
+
+/*
+	Resolve REDUCE_AUTO against the memory budget
+*/
+int CentralityReduction::choose_mode(int requested_mode, int num_verts, int num_threads, long mem_budget_mb) {
+	if( requested_mode != REDUCE_AUTO ) {
+		return requested_mode;
+	}
+	double local_mb = double(num_threads) * num_verts * sizeof(float) / (1024.0*1024.0);
+	if( local_mb <= mem_budget_mb ) {
+		return REDUCE_LOCAL;
+	} else {
+		return REDUCE_ATOMIC;
+	}
+}
+
+/*
+	Called by every thread at the start of the parallel region.
+	Returns the array the thread should add its contributions into.
+	A single thread needs no private copy.
+*/
+float* CentralityReduction::thread_begin() {
+	if( mode == REDUCE_ATOMIC || num_threads == 1 ) {
+		return centrality;
+	}
+
+	// allocated by the owning thread, so its pages are local to it
+	int tid = omp_get_thread_num();
+	local[tid] = new float[num_verts];
+	for(int i=0; i<num_verts; i++) {
+		local[tid][i] = 0.0;
+	}
+	return local[tid];
+}
+
+/*
+	Called by every thread at the end of the parallel region.
+	Waits for all threads, then each thread sums a block
+	of nodes across the private arrays.
+*/
+void CentralityReduction::thread_end() {
+	if( mode == REDUCE_ATOMIC || num_threads == 1 ) {
+		return;
+	}
+
+	#pragma omp barrier
+
+	int team_size = omp_get_num_threads();
+	#pragma omp for
+	for(int v=0; v<num_verts; v++) {
+		float sum = 0.0;
+		for(int t=0; t<team_size; t++) {
+			sum += local[t][v];
+		}
+		centrality[v] += sum;
+	}
+
+	delete [] local[omp_get_thread_num()];
+}
+
+bool CentralityReduction::is_atomic() {
+	return mode == REDUCE_ATOMIC;
+}
+
+int CentralityReduction::get_mode() {
+	return mode;
+}
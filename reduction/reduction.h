@@ -0,0 +1,63 @@
+/*
+	Centrality reduction header, reduction.h
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Combines the centrality contributions of many threads
+	into one shared array without a critical section.
+
+	Two strategies are available:
+
+		REDUCE_LOCAL - each thread accumulates into a private
+		array of num_verts floats, and the private arrays are
+		summed into the shared array when the threads finish.
+		Costs num_threads * num_verts floats of memory.
+
+		REDUCE_ATOMIC - threads add directly into the shared
+		array with atomic updates.  Costs no memory.
+
+	REDUCE_AUTO picks REDUCE_LOCAL when the private arrays
+	fit in the memory budget, and REDUCE_ATOMIC otherwise.
+
+	Usage, inside an omp parallel region:
+
+		float* acc = red.thread_begin();
+		... add into acc, atomically if red.is_atomic() ...
+		red.thread_end();
+
+	This software is distributed under 
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#ifndef REDUCTION_H
+#define REDUCTION_H
+
+enum ReduceMode {
+	REDUCE_AUTO,
+	REDUCE_LOCAL,
+	REDUCE_ATOMIC
+};
+
+class CentralityReduction {
+
+	public:
+		CentralityReduction(float*, int, int, long);
+		~CentralityReduction();
+
+		float* thread_begin();
+		void thread_end();
+
+		bool is_atomic();
+		int get_mode();
+
+		static int choose_mode(int, int, int, long);
+
+	private:
+		float* centrality;
+		int num_verts;
+		int num_threads;
+		int mode;
+		float** local;
+
+};
+
+#endif
@@ -0,0 +1,294 @@
+/*
+	Graph reordering implementation, reorder.cpp
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Degree, Reverse Cuthill-McKee, and community vertex orders,
+	see reorder.h
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "reorder.h"
+#include "radix_sort.h"
+
+/*
+	Label propagation stops after this many rounds, or once a
+	round changes the labels of fewer than one vertex in
+	REORDER_LP_SETTLED
+*/
+#define REORDER_LP_ROUNDS 10
+#define REORDER_LP_SETTLED 1000
+
+/* order of uint64 keys, for qsort */
+static int compare_keys(const void* a, const void* b) {
+	uint64 x = *(const uint64*)a;
+	uint64 y = *(const uint64*)b;
+	return (x < y) ? -1 : (x > y);
+}
+
+/*
+	Sort keys packing a 32-bit rank above a 32-bit value,
+	and write the values, in order of rank, to order
+*/
+static void order_by_rank(uint64* keys, int num_verts, int* order) {
+	radix_sort(keys, NULL, num_verts);
+	for(int i=0; i<num_verts; i++) {
+		order[i] = int(keys[i] & 0xFFFFFFFFULL);
+	}
+}
+
+/* vertices by degree, decreasing if descending, ties by vertex */
+static void degree_order(Graph &g, int* order, bool descending) {
+	int num_verts = g.get_num_verts();
+	uint64* keys = new uint64[num_verts];
+	#pragma omp parallel for
+	for(int v=0; v<num_verts; v++) {
+		unsigned int degree = g.get_degree(v);
+		uint64 rank = descending ? ~degree : degree;
+		keys[v] = (rank << 32) | (unsigned int)v;
+	}
+	order_by_rank(keys, num_verts, order);
+	delete [] keys;
+}
+
+/*
+	Reverse Cuthill-McKee.  Each connected component is searched
+	breadth first from its vertex of least degree, the unvisited
+	neighbors of a vertex queued by increasing degree; the
+	order of discovery, reversed, is the order
+*/
+static void rcm_order(Graph &g, int* order) {
+
+	int num_verts = g.get_num_verts();
+	eid_t* csr1 = g.get_csr1();
+	int* csr2 = g.get_csr2();
+
+	int* by_degree = new int[num_verts];
+	degree_order(g, by_degree, false);
+
+	int max_degree = 0;
+	for(int v=0; v<num_verts; v++) {
+		if( g.get_degree(v) > max_degree ) {
+			max_degree = g.get_degree(v);
+		}
+	}
+	uint64* children = new uint64[max_degree + 1];
+	bool* visited = new bool[num_verts];
+	for(int v=0; v<num_verts; v++) {
+		visited[v] = false;
+	}
+
+	int tail = 0;
+	for(int i=0; i<num_verts; i++) {
+		int s = by_degree[i];
+		if( visited[s] ) {
+			continue;
+		}
+		visited[s] = true;
+		order[tail++] = s;
+		for(int head=tail-1; head<tail; head++) {
+			int u = order[head];
+			int count = 0;
+			for(eid_t j=csr1[u]; j<csr1[u+1]; j++) {
+				int v = csr2[j];
+				if( !visited[v] ) {
+					visited[v] = true;
+					children[count++] = ( uint64(g.get_degree(v)) << 32 ) | (unsigned int)v;
+				}
+			}
+			qsort(children, count, sizeof(uint64), compare_keys);
+			for(int c=0; c<count; c++) {
+				order[tail++] = int(children[c] & 0xFFFFFFFFULL);
+			}
+		}
+	}
+
+	for(int i=0; i<num_verts/2; i++) {
+		int swap_vert = order[i];
+		order[i] = order[num_verts-1-i];
+		order[num_verts-1-i] = swap_vert;
+	}
+
+	delete [] by_degree;
+	delete [] children;
+	delete [] visited;
+}
+
+/*
+	A hash of a label that changes each round, to break ties
+	between labels without favoring the smallest, which would
+	spread one label over the whole graph
+*/
+static inline uint64 label_hash(uint64 label, int round) {
+	uint64 x = label * 0x9E3779B97F4A7C15ULL + uint64(round) * 0xBF58476D1CE4E5B9ULL;
+	x ^= x >> 31;
+	x *= 0x94D049BB133111EBULL;
+	return x ^ (x >> 29);
+}
+
+/*
+	Communities by label propagation: every vertex starts in its
+	own community and, in rounds, joins the one most common among
+	its neighbors, keeping its own on a tie, and otherwise the
+	label of least hash.  Communities are laid out in the order their
+	first vertex was read, and within, in breadth-first order, so
+	neighbors sit together as in Gorder
+*/
+static void community_order(Graph &g, int* order) {
+
+	int num_verts = g.get_num_verts();
+	eid_t* csr1 = g.get_csr1();
+	int* csr2 = g.get_csr2();
+
+	int max_degree = 0;
+	int* label = new int[num_verts];
+	for(int v=0; v<num_verts; v++) {
+		label[v] = v;
+		if( g.get_degree(v) > max_degree ) {
+			max_degree = g.get_degree(v);
+		}
+	}
+	uint64* neighbor_labels = new uint64[max_degree + 1];
+
+	for(int round=0; round<REORDER_LP_ROUNDS; round++) {
+		int changed = 0;
+		for(int v=0; v<num_verts; v++) {
+			int degree = g.get_degree(v);
+			if( degree == 0 ) {
+				continue;
+			}
+			for(int j=0; j<degree; j++) {
+				neighbor_labels[j] = label[ csr2[csr1[v]+j] ];
+			}
+			qsort(neighbor_labels, degree, sizeof(uint64), compare_keys);
+
+			// the longest run of one label, ties to the smallest hash
+			int best = label[v];
+			int best_count = 0;
+			uint64 best_hash = 0;
+			int own_count = 0;
+			for(int j=0; j<degree; ) {
+				int k = j;
+				while( k < degree && neighbor_labels[k] == neighbor_labels[j] ) {
+					k++;
+				}
+				if( int(neighbor_labels[j]) == label[v] ) {
+					own_count = k - j;
+				}
+				uint64 hash = label_hash(neighbor_labels[j], round);
+				if( k - j > best_count || ( k - j == best_count && hash < best_hash ) ) {
+					best = int(neighbor_labels[j]);
+					best_count = k - j;
+					best_hash = hash;
+				}
+				j = k;
+			}
+			if( best != label[v] && best_count > own_count ) {
+				label[v] = best;
+				changed++;
+			}
+		}
+		if( changed * (long long)REORDER_LP_SETTLED < num_verts ) {
+			break;
+		}
+	}
+
+	// rank each community by its first vertex
+	int* rank = new int[num_verts];
+	for(int v=0; v<num_verts; v++) {
+		rank[v] = -1;
+	}
+	int num_communities = 0;
+	for(int v=0; v<num_verts; v++) {
+		if( rank[label[v]] < 0 ) {
+			rank[label[v]] = num_communities++;
+		}
+	}
+
+	// number the vertices breadth first, without leaving a community
+	int* visit = new int[num_verts];
+	int* queue = new int[num_verts];
+	for(int v=0; v<num_verts; v++) {
+		visit[v] = -1;
+	}
+	int tail = 0;
+	for(int s=0; s<num_verts; s++) {
+		if( visit[s] >= 0 ) {
+			continue;
+		}
+		visit[s] = tail;
+		queue[tail++] = s;
+		for(int head=tail-1; head<tail; head++) {
+			int u = queue[head];
+			for(eid_t j=csr1[u]; j<csr1[u+1]; j++) {
+				int w = csr2[j];
+				if( visit[w] < 0 && label[w] == label[u] ) {
+					visit[w] = tail;
+					queue[tail++] = w;
+				}
+			}
+		}
+	}
+
+	uint64* keys = new uint64[num_verts];
+	#pragma omp parallel for
+	for(int v=0; v<num_verts; v++) {
+		keys[v] = ( uint64(rank[label[v]]) << 32 ) | (unsigned int)visit[v];
+	}
+	order_by_rank(keys, num_verts, order);
+	for(int i=0; i<num_verts; i++) {
+		order[i] = queue[order[i]];
+	}
+
+	printf("Label propagation found %d communities\n", num_communities);
+
+	delete [] label;
+	delete [] neighbor_labels;
+	delete [] rank;
+	delete [] visit;
+	delete [] queue;
+	delete [] keys;
+}
+
+/*
+	The vertex order of method, a ReorderMethod, for graph g:
+	order[i] is the vertex to become vertex i.
+	The caller deletes the order
+*/
+int* reorder_order(Graph &g, int method) {
+	int num_verts = g.get_num_verts();
+	int* order = new int[num_verts];
+	switch( method ) {
+		case REORDER_DEGREE:
+			degree_order(g, order, true);
+			break;
+		case REORDER_RCM:
+			rcm_order(g, order);
+			break;
+		case REORDER_COMMUNITY:
+			community_order(g, order);
+			break;
+		default:
+			for(int v=0; v<num_verts; v++) {
+				order[v] = v;
+			}
+	}
+	return order;
+}
+
+const char* reorder_name(int method) {
+	switch( method ) {
+		case REORDER_DEGREE:
+			return "decreasing degree";
+		case REORDER_RCM:
+			return "reverse Cuthill-McKee";
+		case REORDER_COMMUNITY:
+			return "label propagation communities";
+		default:
+			return "none";
+	}
+}
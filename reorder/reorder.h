@@ -0,0 +1,50 @@
+/*
+	Graph reordering header, reorder.h
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Vertex orders that place the vertices a search reads together
+	near each other in memory, so the per-node arrays of Brandes
+	are read with fewer cache misses.  A graph keeps the numbering
+	it was read with, which is usually the input's order; after
+	load, Graph::reorder renumbers it by one of:
+
+		REORDER_DEGREE - by decreasing degree, so the hubs that
+		nearly every search reaches share cache lines
+
+		REORDER_RCM - Reverse Cuthill-McKee: a breadth-first
+		order from a vertex of least degree, neighbors taken by
+		increasing degree, reversed, which keeps every edge's
+		endpoints close together
+
+		REORDER_COMMUNITY - communities found by label propagation
+		laid out one after another, each in breadth-first order,
+		a lightweight stand-in for Rabbit order and Gorder, so
+		the dense neighborhoods a search walks through are
+		contiguous
+
+	reorder_order returns the order, order[i] the vertex that
+	becomes vertex i.  Results are still written by the original
+	ids, see Graph::reorder.  Which order pays off depends on the
+	graph; the reordering time is printed beside the betweenness
+	runtime, and bench/reorder.sh compares them.
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#ifndef REORDER_H
+#define REORDER_H
+
+#include "graph.h"
+
+enum ReorderMethod {
+	REORDER_NONE,
+	REORDER_DEGREE,
+	REORDER_RCM,
+	REORDER_COMMUNITY
+};
+
+int* reorder_order(Graph&, int);
+const char* reorder_name(int);
+
+#endif
@@ -0,0 +1,372 @@
+/*
+	Algebraic batched Brandes implementation, spmm.cpp
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Sparse matrix times dense matrix products over the CSR
+	graph for a batch of sources, see spmm.h
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "spmm.h"
+
+/*
+	A pull product scans every node, not only those left to
+	reach; a scan of this many nodes is counted as one row read
+	when choosing between a push and a pull, as in brandes_bfs
+*/
+#define SPMM_NODES_PER_ROW 16
+
+SpMMBrandes::SpMMBrandes(Graph &g, int batch_width) {
+	num_verts = g.get_num_verts();
+	width = batch_width;
+	num_sources = 0;
+	graph = &g;
+	csr1 = g.get_csr1();
+	csr2 = g.get_csr2();
+	comps = new int[width];
+	comp_sources = new int[width];
+	num_comps = 0;
+	comp_verts = 0;
+
+	size_t cells = size_t(num_verts) * width;
+	depth = new int[cells];
+	num_paths = new sigma_t[cells];
+	frontier = new sigma_t[cells];
+	product = new sigma_t[cells];
+	delta = new float[cells];
+	for(size_t i=0; i<cells; i++) {
+		depth[i] = -1;
+		num_paths[i] = 0;
+		delta[i] = 0.0;
+	}
+	unreached = new int[num_verts];
+	active = new bool[num_verts];
+	next_active = new bool[num_verts];
+	touched = new int[num_verts];
+	for(int v=0; v<num_verts; v++) {
+		active[v] = false;
+		next_active[v] = false;
+	}
+
+	// a node is listed once for each level it is reached on
+	level_nodes_capacity = num_verts + width;
+	level_nodes = (int*)malloc( level_nodes_capacity*sizeof(int) );
+	if( level_nodes == NULL ) {
+		printf("bad SpMMBrandes malloc of level nodes: %d\n", level_nodes_capacity);
+		exit(1);
+	}
+	num_level_nodes = 0;
+	level_start = new int[num_verts+2];
+
+	row_adds = 0;
+}
+
+SpMMBrandes::~SpMMBrandes() {
+	delete [] comps;
+	delete [] comp_sources;
+	delete [] depth;
+	delete [] num_paths;
+	delete [] frontier;
+	delete [] product;
+	delete [] delta;
+	delete [] unreached;
+	delete [] active;
+	delete [] next_active;
+	delete [] touched;
+	free(level_nodes);
+	delete [] level_start;
+}
+
+/* memory per node of one SpMMBrandes of the width */
+size_t SpMMBrandes::bytes_per_node(int batch_width) {
+	return batch_width * ( sizeof(int) + 3*sizeof(sigma_t) + sizeof(float) )
+		+ 4*sizeof(int) + 2*sizeof(bool);
+}
+
+/* dense rows added into products, summed over batches */
+long long SpMMBrandes::get_row_adds() {
+	return row_adds;
+}
+
+/* list node v on the level being built */
+void SpMMBrandes::add_level_node(int v) {
+	if( num_level_nodes == level_nodes_capacity ) {
+		level_nodes_capacity *= 2;
+		level_nodes = (int*)realloc( level_nodes, level_nodes_capacity*sizeof(int) );
+		if( level_nodes == NULL ) {
+			printf("bad SpMMBrandes realloc of level nodes: %d\n", level_nodes_capacity);
+			exit(1);
+		}
+	}
+	level_nodes[num_level_nodes++] = v;
+}
+
+/*
+	Run Brandes from the num_sources distinct nodes of sources,
+	at most the batch width, adding their dependencies, times
+	scale, into centrality, with atomic updates if it is shared.
+	Columns past num_sources hold no source and reach nothing.
+	Only the components of the sources can be reached, so a node
+	is left to reach by the sources of its component, and only
+	the nodes of those components are set up and pulled into
+*/
+void SpMMBrandes::run(int* sources, int count, float* centrality, bool atomic, float scale) {
+
+	num_sources = count;
+	num_comps = 0;
+	comp_verts = 0;
+	for(int c=0; c<num_sources; c++) {
+		int comp = graph->get_component(sources[c]);
+		int k = 0;
+		while( k < num_comps && comps[k] != comp ) {
+			k++;
+		}
+		if( k == num_comps ) {
+			comps[num_comps] = comp;
+			comp_sources[num_comps++] = 0;
+			comp_verts += graph->get_component_size(comp);
+		}
+		comp_sources[k]++;
+	}
+	for(int k=0; k<num_comps; k++) {
+		int* verts = graph->get_component_verts(comps[k]);
+		int size = graph->get_component_size(comps[k]);
+		for(int i=0; i<size; i++) {
+			unreached[verts[i]] = comp_sources[k];
+		}
+	}
+
+	num_level_nodes = 0;
+	level_start[0] = 0;
+	for(int c=0; c<num_sources; c++) {
+		int s = sources[c];
+		sigma_t* row = &frontier[size_t(s)*width];
+		for(int b=0; b<width; b++) {
+			row[b] = 0;
+		}
+		row[c] = 1;
+		depth[size_t(s)*width + c] = 0;
+		num_paths[size_t(s)*width + c] = 1;
+		unreached[s]--;
+		active[s] = true;
+		add_level_node(s);
+	}
+	level_start[1] = num_level_nodes;
+
+	int num_levels = forward();
+	backward(num_levels, centrality, atomic, scale);
+	reset();
+}
+
+/*
+	Keep the sums of product row v in the columns that had not
+	reached v, as its path counts at level+1 and its next
+	frontier row.  Returns the number of columns taken
+*/
+int SpMMBrandes::take_columns(int v, int level) {
+	sigma_t* out = &product[size_t(v)*width];
+	int* d = &depth[size_t(v)*width];
+	sigma_t* paths = &num_paths[size_t(v)*width];
+	int taken = 0;
+	for(int b=0; b<width; b++) {
+		sigma_t p = (d[b] < 0) ? out[b] : 0;
+		int take = (p > 0);
+		d[b] = take ? level+1 : d[b];
+		paths[b] = take ? p : paths[b];
+		out[b] = p;
+		taken += take;
+	}
+	unreached[v] -= taken;
+	return taken;
+}
+
+/*
+	The forward products, one per level, until a level
+	reaches no node.  Returns the number of levels
+*/
+int SpMMBrandes::forward() {
+
+	long long unreached_rows = 0;
+	for(int k=0; k<num_comps; k++) {
+		unreached_rows += graph->get_component_edges(comps[k]);
+	}
+
+	int level = 0;
+	for( ; level_start[level+1] > level_start[level]; level++) {
+
+		long long frontier_rows = 0;
+		for(int i=level_start[level]; i<level_start[level+1]; i++) {
+			int u = level_nodes[i];
+			frontier_rows += csr1[u+1] - csr1[u];
+		}
+
+		int num_touched = 0;
+		if( frontier_rows < unreached_rows + comp_verts/SPMM_NODES_PER_ROW ) {
+			// push the level's rows to the neighbors they may reach
+			for(int i=level_start[level]; i<level_start[level+1]; i++) {
+				int u = level_nodes[i];
+				const sigma_t* in = &frontier[size_t(u)*width];
+				eid_t offset = csr1[u];
+				int degree = csr1[u+1] - offset;
+				for(int j=0; j<degree; j++) {
+					int v = csr2[j+offset];
+					if( unreached[v] == 0 ) {
+						continue;
+					}
+					sigma_t* out = &product[size_t(v)*width];
+					if( !next_active[v] ) {
+						next_active[v] = true;
+						touched[num_touched++] = v;
+						for(int b=0; b<width; b++) {
+							out[b] = 0;
+						}
+					}
+					for(int b=0; b<width; b++) {
+						out[b] += in[b];
+					}
+					row_adds++;
+				}
+			}
+		} else {
+			// pull the rows of the level into every node left to reach
+			for(int k=0; k<num_comps; k++) {
+				int* verts = graph->get_component_verts(comps[k]);
+				int size = graph->get_component_size(comps[k]);
+				for(int i=0; i<size; i++) {
+					int v = verts[i];
+					if( unreached[v] == 0 ) {
+						continue;
+					}
+					sigma_t* out = &product[size_t(v)*width];
+					eid_t offset = csr1[v];
+					int degree = csr1[v+1] - offset;
+					for(int j=0; j<degree; j++) {
+						int u = csr2[j+offset];
+						if( !active[u] ) {
+							continue;
+						}
+						if( !next_active[v] ) {
+							next_active[v] = true;
+							touched[num_touched++] = v;
+							for(int b=0; b<width; b++) {
+								out[b] = 0;
+							}
+						}
+						const sigma_t* in = &frontier[size_t(u)*width];
+						for(int b=0; b<width; b++) {
+							out[b] += in[b];
+						}
+						row_adds++;
+					}
+				}
+			}
+		}
+
+		// the touched nodes that took a column form the next level
+		for(int i=level_start[level]; i<level_start[level+1]; i++) {
+			active[level_nodes[i]] = false;
+		}
+		for(int t=0; t<num_touched; t++) {
+			int v = touched[t];
+			next_active[v] = false;
+			if( take_columns(v, level) > 0 ) {
+				active[v] = true;
+				add_level_node(v);
+				if( unreached[v] == 0 ) {
+					unreached_rows -= csr1[v+1] - csr1[v];
+				}
+			}
+		}
+		level_start[level+2] = num_level_nodes;
+
+		sigma_t* swap_rows = frontier;
+		frontier = product;
+		product = swap_rows;
+	}
+	return level;
+}
+
+/*
+	The backward products, deepest level first.  For level l,
+	the operand rows of the nodes on level l+1 hold
+	(1 + delta) / num_paths in their columns on l+1, and each
+	node on level l takes the product in its columns on l,
+	times its path count, as its dependency, which is added to
+	the centrality.  Sources, on level 0, add no centrality
+*/
+void SpMMBrandes::backward(int num_levels, float* centrality, bool atomic, float scale) {
+
+	for(int l=num_levels-2; l>=1; l--) {
+
+		for(int i=level_start[l+1]; i<level_start[l+2]; i++) {
+			int v = level_nodes[i];
+			int* d = &depth[size_t(v)*width];
+			sigma_t* paths = &num_paths[size_t(v)*width];
+			float* dv = &delta[size_t(v)*width];
+			sigma_t* w = &frontier[size_t(v)*width];
+			for(int b=0; b<width; b++) {
+				w[b] = ( d[b] == l+1 ) ? (1 + dv[b]) / paths[b] : 0;
+			}
+			active[v] = true;
+		}
+
+		for(int i=level_start[l]; i<level_start[l+1]; i++) {
+			int v = level_nodes[i];
+			sigma_t* out = &product[size_t(v)*width];
+			for(int b=0; b<width; b++) {
+				out[b] = 0;
+			}
+			eid_t offset = csr1[v];
+			int degree = csr1[v+1] - offset;
+			for(int j=0; j<degree; j++) {
+				int u = csr2[j+offset];
+				if( !active[u] ) {
+					continue;
+				}
+				const sigma_t* in = &frontier[size_t(u)*width];
+				for(int b=0; b<width; b++) {
+					out[b] += in[b];
+				}
+				row_adds++;
+			}
+
+			int* d = &depth[size_t(v)*width];
+			sigma_t* paths = &num_paths[size_t(v)*width];
+			float* dv = &delta[size_t(v)*width];
+			float sum = 0.0;
+			for(int b=0; b<width; b++) {
+				float dep = ( d[b] == l ) ? float(paths[b] * out[b]) : 0;
+				dv[b] = ( d[b] == l ) ? dep : dv[b];
+				sum += dep;
+			}
+			if( atomic ) {
+				#pragma omp atomic
+				centrality[v] += sum*scale;
+			} else {
+				centrality[v] += sum*scale;
+			}
+		}
+
+		for(int i=level_start[l+1]; i<level_start[l+2]; i++) {
+			active[level_nodes[i]] = false;
+		}
+	}
+}
+
+/* restore the rows of every listed node, the nodes the batch reached */
+void SpMMBrandes::reset() {
+	for(int i=0; i<num_level_nodes; i++) {
+		int v = level_nodes[i];
+		for(int b=0; b<width; b++) {
+			depth[size_t(v)*width + b] = -1;
+			num_paths[size_t(v)*width + b] = 0;
+			delta[size_t(v)*width + b] = 0.0;
+		}
+	}
+	num_level_nodes = 0;
+}
@@ -0,0 +1,118 @@
+/*
+	Algebraic batched Brandes header, spmm.h
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Brandes on an unweighted graph for a batch of sources,
+	written as products of the adjacency matrix, the graph's
+	csr1 and csr2, with dense matrices of one row per node and
+	one column per source of the batch, the batch width.
+
+	Forward, level by level, the frontier matrix holds the path
+	counts of the nodes on the level, zero elsewhere; the product
+	of the adjacency matrix and the frontier gives each node the
+	paths arriving from the level, and the columns in which the
+	node was not yet reached become its path counts and the next
+	frontier.  Backward, deepest level first, each node on the
+	level below scales its dependency, (1 + delta) / num_paths,
+	and the product gives each node on the level the sum over
+	its children, times its own path count.
+
+	A product adds whole rows of a dense matrix; the inner loop
+	runs over the batch width with unit stride and no branches,
+	so the compiler vectorizes it.  Only the rows of nodes on a
+	level are used, by a flag per row, and the nodes of each level
+	are listed, so a product costs the edges of its rows rather
+	than a pass over the matrix.  A forward product is a pull,
+	each node not yet reached by every column summing its
+	neighbors' rows, or while the level is small, a push of the
+	level's rows to their neighbors, whichever reads fewer rows.
+
+	The batch width is the length of the inner loop, so the
+	default is SPMM_MAX_WIDTH, narrowed only to fit the memory
+	budget; a narrower batch does not make the dense matrices
+	fit a cache, it adds batches, each another pass over the
+	CSR.  The products are not tiled by rows: on a sparse graph
+	a tile of rows holds about one edge per row it writes, so
+	tiling would stream the product rows once per edge rather
+	than once per product.
+
+	Members, each num_verts * width, row major:
+
+		depth - level of each node per column, -1 if unreached
+
+		num_paths - path counts
+
+		frontier, product - the dense operand and result of
+		the current product
+
+		delta - dependencies
+
+	and per node, unreached, the columns not yet reaching it,
+	and active, whether its row of the dense operand is in use.
+	level_nodes lists the nodes of each level, from level_start.
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#ifndef SPMM_H
+#define SPMM_H
+
+#include <cstddef>
+
+#include "graph.h"
+
+#define SPMM_MAX_WIDTH 64
+
+class SpMMBrandes {
+
+	public:
+		SpMMBrandes(Graph&, int);
+		~SpMMBrandes();
+
+		void run(int*, int, float*, bool, float);
+
+		long long get_row_adds();
+
+		static size_t bytes_per_node(int);
+
+	private:
+		int forward();
+		void backward(int, float*, bool, float);
+		void reset();
+		void add_level_node(int);
+		int take_columns(int, int);
+
+		int num_verts;
+		int width;
+		int num_sources;
+		Graph* graph;
+		eid_t* csr1;
+		int* csr2;
+
+		int* comps;
+		int* comp_sources;
+		int num_comps;
+		int comp_verts;
+
+		int* depth;
+		sigma_t* num_paths;
+		sigma_t* frontier;
+		sigma_t* product;
+		float* delta;
+
+		int* unreached;
+		bool* active;
+		bool* next_active;
+		int* touched;
+
+		int* level_nodes;
+		int num_level_nodes;
+		int level_nodes_capacity;
+		int* level_start;
+
+		long long row_adds;
+
+};
+
+#endif
@@ -0,0 +1,282 @@
+/*
+	Structural twins implementation, twins.cpp
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Group twins, search the quotient graph, and add the paths
+	between twins, see twins.h
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <omp.h>
+
+#include "twins.h"
+#include "workspace.h"
+#include "radix_heap.h"
+#include "reduction.h"
+#include "radix_sort.h"
+
+/* a mix of one neighbor and the weight of its edge, for row hashes */
+static inline uint64 edge_hash(int neighbor, int weight) {
+	uint64 x = ( uint64((unsigned int)neighbor) << 32 ) | (unsigned int)weight;
+	x += 0x9E3779B97F4A7C15ULL;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+	return x ^ (x >> 31);
+}
+
+/*
+	Whether the row of v lists v, or a neighbor twice;
+	seen holds a stamp per node, set to v+1 for its neighbors
+*/
+static bool irregular_row(Graph &g, int v, int* seen) {
+	eid_t* csr1 = g.get_csr1();
+	int* csr2 = g.get_csr2();
+	for(eid_t j=csr1[v]; j<csr1[v+1]; j++) {
+		int w = csr2[j];
+		if( w == v || seen[w] == v+1 ) {
+			return true;
+		}
+		seen[w] = v+1;
+	}
+	return false;
+}
+
+/*
+	Group the nodes of g into classes of twins, class_of[v] the
+	class of node v, classes numbered in order of their first
+	node, which is rep[c]; size[c] is the number in class c.
+	Returns the number of classes
+*/
+static int group_twins(Graph &g, int* class_of, int* rep, int* size) {
+
+	int num_verts = g.get_num_verts();
+	eid_t* csr1 = g.get_csr1();
+	int* csr2 = g.get_csr2();
+	int* weights = g.get_weights();
+
+	// hash every row that has edges, as a sum, so order does not matter
+	uint64* keys = new uint64[num_verts];
+	int* nodes = new int[num_verts];
+	int num_keys = 0;
+	for(int v=0; v<num_verts; v++) {
+		if( csr1[v+1] > csr1[v] ) {
+			nodes[num_keys++] = v;
+		}
+	}
+	#pragma omp parallel for schedule(dynamic, 256)
+	for(int i=0; i<num_keys; i++) {
+		int v = nodes[i];
+		uint64 hash = uint64(csr1[v+1] - csr1[v]);
+		for(eid_t j=csr1[v]; j<csr1[v+1]; j++) {
+			hash += edge_hash(csr2[j], (weights == NULL) ? 1 : weights[j]);
+		}
+		keys[i] = hash;
+	}
+	radix_sort(keys, nodes, num_keys);
+
+	// equal hashes are twins if their rows match; first is the
+	// lowest node of each class, since the sort is stable
+	int* first = new int[num_verts];
+	int* seen = new int[num_verts];
+	int* mark = new int[num_verts];
+	int* mark_weight = new int[num_verts];
+	for(int v=0; v<num_verts; v++) {
+		first[v] = v;
+		seen[v] = 0;
+		mark[v] = -1;
+	}
+	for(int i=0; i<num_keys; ) {
+		int end = i + 1;
+		while( end < num_keys && keys[end] == keys[i] ) {
+			end++;
+		}
+		for(int a=i; a<end; a++) {
+			int u = nodes[a];
+			if( first[u] != u || end - i == 1 || irregular_row(g, u, seen) ) {
+				continue;
+			}
+			for(eid_t j=csr1[u]; j<csr1[u+1]; j++) {
+				mark[csr2[j]] = u;
+				mark_weight[csr2[j]] = (weights == NULL) ? 1 : weights[j];
+			}
+			for(int b=a+1; b<end; b++) {
+				int v = nodes[b];
+				if( first[v] != v || csr1[v+1]-csr1[v] != csr1[u+1]-csr1[u] ) {
+					continue;
+				}
+				bool same = true;
+				for(eid_t j=csr1[v]; j<csr1[v+1] && same; j++) {
+					same = ( mark[csr2[j]] == u && mark_weight[csr2[j]] == ((weights == NULL) ? 1 : weights[j]) );
+				}
+				if( same && !irregular_row(g, v, seen) ) {
+					first[v] = u;
+				}
+			}
+		}
+		i = end;
+	}
+
+	int num_classes = 0;
+	for(int v=0; v<num_verts; v++) {
+		if( first[v] == v ) {
+			rep[num_classes] = v;
+			size[num_classes] = 0;
+			class_of[v] = num_classes++;
+		}
+		class_of[v] = class_of[first[v]];
+		size[class_of[v]]++;
+	}
+
+	delete [] keys;
+	delete [] nodes;
+	delete [] first;
+	delete [] seen;
+	delete [] mark;
+	delete [] mark_weight;
+	return num_classes;
+}
+
+/*
+	The quotient graph, the row of each class that of its first
+	node, keeping one neighbor per class, that class's first node
+*/
+static Graph* quotient_graph(Graph &g, int* class_of, int* rep, int num_classes) {
+
+	eid_t* csr1 = g.get_csr1();
+	int* csr2 = g.get_csr2();
+	int* weights = g.get_weights();
+
+	eid_t* row_offsets = new eid_t[num_classes+1];
+	row_offsets[0] = 0;
+	for(int c=0; c<num_classes; c++) {
+		int u = rep[c];
+		eid_t count = 0;
+		for(eid_t j=csr1[u]; j<csr1[u+1]; j++) {
+			if( rep[class_of[csr2[j]]] == csr2[j] ) {
+				count++;
+			}
+		}
+		row_offsets[c+1] = row_offsets[c] + count;
+	}
+
+	eid_t num_edges = row_offsets[num_classes];
+	int* neighbors = new int[num_edges];
+	int* edge_weights = (weights == NULL) ? NULL : new int[num_edges];
+	#pragma omp parallel for schedule(dynamic, 64)
+	for(int c=0; c<num_classes; c++) {
+		int u = rep[c];
+		eid_t k = row_offsets[c];
+		for(eid_t j=csr1[u]; j<csr1[u+1]; j++) {
+			if( rep[class_of[csr2[j]]] == csr2[j] ) {
+				neighbors[k] = class_of[csr2[j]];
+				if( weights != NULL ) {
+					edge_weights[k] = weights[j];
+				}
+				k++;
+			}
+		}
+	}
+
+	return new Graph(num_classes, num_edges, row_offsets, neighbors, edge_weights, g.get_filename());
+}
+
+/*
+	Add, per class, the paths between the twins of each other
+	class, see twins.h, into each node's share, class_centrality;
+	every edge has length 1 unless weighted
+*/
+static void add_twin_pairs(Graph &q, int* size, float* class_centrality, bool weighted) {
+
+	int num_classes = q.get_num_verts();
+	eid_t* csr1 = q.get_csr1();
+	int* csr2 = q.get_csr2();
+	int* weights = weighted ? q.get_weights() : NULL;
+
+	for(int c=0; c<num_classes; c++) {
+		if( size[c] < 2 || csr1[c+1] == csr1[c] ) {
+			continue;
+		}
+		int lightest = (weights == NULL) ? 1 : weights[csr1[c]];
+		for(eid_t j=csr1[c]; j<csr1[c+1]; j++) {
+			if( weights != NULL && weights[j] < lightest ) {
+				lightest = weights[j];
+			}
+		}
+		double paths = 0.0;
+		for(eid_t j=csr1[c]; j<csr1[c+1]; j++) {
+			if( weights == NULL || weights[j] == lightest ) {
+				paths += size[csr2[j]];
+			}
+		}
+		double pairs = 0.5 * double(size[c]) * (size[c] - 1);
+		for(eid_t j=csr1[c]; j<csr1[c+1]; j++) {
+			if( weights == NULL || weights[j] == lightest ) {
+				class_centrality[csr2[j]] += float( pairs / paths );
+			}
+		}
+	}
+}
+
+/*
+	Exact betweenness with twins searched once, see twins.h.
+	The quotient graph is searched with the Dijkstra engine if
+	the exact computation would use Dijkstra or delta-stepping,
+	and otherwise with the BFS engine, a Workspace per thread.
+	Returns the number of classes
+*/
+int brandes_twins(Graph &g, float* centrality, BrandesOptions &opts) {
+
+	int num_verts = g.get_num_verts();
+	int* class_of = new int[num_verts];
+	int* rep = new int[num_verts];
+	int* size = new int[num_verts];
+	int num_classes = group_twins(g, class_of, rep, size);
+
+	Graph* q = quotient_graph(g, class_of, rep, num_classes);
+	printf("Grouped %d vertices into %d classes of twins, %lld quotient edges\n", num_verts, num_classes, (long long)q->get_num_undir_edges());
+
+	int engine = choose_engine(g, opts);
+	bool weighted = ( engine == ENGINE_DIJKSTRA || engine == ENGINE_DELTA_STEPPING );
+
+	float* class_centrality = new float[num_classes];
+	for(int c=0; c<num_classes; c++) {
+		class_centrality[c] = 0.0;
+	}
+	CentralityReduction red(class_centrality, num_classes, opts.reduce_mode, opts.mem_budget_mb);
+
+	#pragma omp parallel
+	{
+		Workspace ws(num_classes);
+		RadixHeap heap;
+		float* acc = red.thread_begin();
+		bool atomic = red.is_atomic();
+
+		#pragma omp for schedule(dynamic, 8)
+		for(int c=0; c<num_classes; c++) {
+			if( weighted ) {
+				brandes_dijkstra_source(*q, ws, heap, c, acc, atomic, 0.5, false, NULL, size);
+			} else {
+				brandes_bfs_source(*q, ws, c, acc, atomic, 0.5, false, opts.bfs_direction, NULL, size);
+			}
+		}
+
+		red.thread_end();
+	}
+	add_twin_pairs(*q, size, class_centrality, weighted);
+
+	#pragma omp parallel for
+	for(int v=0; v<num_verts; v++) {
+		centrality[v] = class_centrality[class_of[v]];
+	}
+
+	delete q;
+	delete [] class_of;
+	delete [] rep;
+	delete [] size;
+	delete [] class_centrality;
+	return num_classes;
+}
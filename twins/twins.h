@@ -0,0 +1,41 @@
+/*
+	Structural twins header, twins.h
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Exact betweenness with structural twins, nodes of the same
+	neighbors and edge weights, searched once per class.
+
+	Twins are found by hashing each row, independent of the order
+	of its neighbors, radix sorting the hashes, and comparing the
+	rows of equal hash.  Twins are never adjacent, and their shortest
+	path DAGs match, so their betweenness is the same.  The quotient
+	graph has a node per class of twins, and an edge between two
+	classes whose nodes are adjacent; a class of m twins stands for
+	m sources, m targets, and m ways through, so brandes_bfs_source
+	or brandes_dijkstra_source, see brandes.h, with twins[class] = m,
+	counts every pair of nodes in different classes.
+
+	A pair of twins s, t is at distance twice the lightest edge
+	of their rows, through each neighbor c at that weight, so
+	each of those neighbors lies on one of the paths
+
+		sigma = the number of such neighbors
+
+	and gains m(m-1)/2 / sigma over the class's pairs.
+
+	Results are written per node as usual; nodes of a row that
+	lists a node twice, or the node itself, are not grouped.
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#ifndef TWINS_H
+#define TWINS_H
+
+#include "graph.h"
+#include "brandes.h"
+
+int brandes_twins(Graph&, float*, BrandesOptions&);
+
+#endif
@@ -0,0 +1,36 @@
+/*
+	Adjlist to binary driver, adjlist_to_binary.cpp
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Convert an adjacency list, see edgelist_to_adjlist_driver.cpp,
+	to the binary CSR format of graph_binary.h, which betweenness
+	maps into memory instead of parsing
+
+	This software is distributed under 
+	the modified Berkeley Software Distribution (BSD) License.
+
+*/
+#include<cstdio>
+#include<string>
+
+#include "graph.h"
+#include "graph_binary.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+
+	if( argc != 3 ) {
+		printf("usage: ./adjlist_to_binary  [adjacencylist_in]  [binary_out]\n");
+		return -1;
+	}
+
+	Graph g(argv[1]);
+	if( !write_binary_graph(argv[2], g.get_num_verts(), g.get_num_dir_edges(), g.get_csr1(), g.get_csr2(), g.get_weights(), g.get_orig_ids(), "") ) {
+		printf("could not write %s\n", argv[2]);
+		return 1;
+	}
+	printf("Wrote %d vertices and %lld edges%s to %s\n", g.get_num_verts(), (long long)g.get_num_undir_edges(), g.is_weighted() ? ", weighted," : "", argv[2]);
+
+	return 0;
+}
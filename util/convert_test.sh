@@ -0,0 +1,54 @@
+#!/bin/sh
+#
+#	Edgelist conversion test, convert_test.sh
+#	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+#
+#	Converts an edgelist that mixes weighted and unweighted
+#	lines, in memory, out of core, and to binary, and checks
+#	that an edge listed without a weight has weight 1, as when
+#	betweenness reads the edgelist itself.
+#
+#	usage, from the main directory after make all:
+#
+#		./util/convert_test.sh
+#
+#	This software is distributed under
+#	the modified Berkeley Software Distribution (BSD) License.
+#
+
+DIR=/tmp/convert_test.$$
+mkdir -p $DIR
+FAIL=0
+
+# 1 2 has no weight, so 0 2 is as short as 0 1 2 only if it is 0
+printf "0 1 1\n1 2\n0 2 1\n2 1 5\n" > $DIR/mixed.el
+printf "0 1:1 2:1\n1 0:1 2:1\n2 0:1 1:1\n" > $DIR/expected.adj
+
+./util/edgelist_to_adjlist $DIR/mixed.el $DIR/mem.adj > /dev/null
+./util/edgelist_to_adjlist --mem 1 --tmp $DIR $DIR/mixed.el $DIR/ext.adj > /dev/null
+./util/edgelist_to_adjlist --binary $DIR/mixed.el $DIR/bin.bcsr > /dev/null
+./util/edgelist_to_adjlist --mem 1 --tmp $DIR --binary $DIR/mixed.el $DIR/extbin.bcsr > /dev/null
+for OUT in mem.adj ext.adj; do
+	if ! cmp -s $DIR/expected.adj $DIR/$OUT; then
+		echo "FAIL: $OUT differs from the expected adjacency list"
+		FAIL=1
+	fi
+done
+
+./betweenness $DIR/mixed.el $DIR/el.out > /dev/null
+for IN in mem.adj ext.adj bin.bcsr extbin.bcsr; do
+	if ! ./betweenness $DIR/$IN $DIR/$IN.out > /dev/null || ! cmp -s $DIR/el.out $DIR/$IN.out; then
+		echo "FAIL: betweenness of $IN differs from that of the edgelist"
+		FAIL=1
+	fi
+done
+if ! grep -q "^1	0.0000000$" $DIR/el.out; then
+	echo "FAIL: vertex 1 lies on a shortest path"
+	FAIL=1
+fi
+
+rm -rf $DIR
+if [ $FAIL -eq 0 ]; then
+	echo "PASS"
+fi
+exit $FAIL
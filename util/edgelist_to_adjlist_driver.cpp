@@ -15,6 +15,8 @@
 				i.e. for vertex 5:
 				5 1 2 3 6 10				
 		- tab delimmited
+		- optionally weighted: a third edgelist column gives
+				the edge weight, written neighbor_id:weight
 		- rows sorted by vertex_id
 		- list of neighbors sorted by neighbor_id
 
@@ -27,51 +29,76 @@
 #include<string>
 #include<fstream>
 #include<cstdlib>
-#include<set>
-#include<map>
+#include<cstring>
 #include<algorithm>
 
 #include "edgelist_to_adjlist_utils.cpp"
+#include "edgelist_to_adjlist_external.cpp"
 
 using namespace std;
 
 int main(int argc, char* argv[]) {
 
-	if(argc !=3) {
-		cout << "usage:  ./edge_to_adj   edgelist   adjlist" << endl;
+	long long mem_mb = 0;
+	bool binary = false;
+	string tmp_dir;
+	int arg = 1;
+	for( ; arg < argc && strncmp(argv[arg], "--", 2) == 0; arg++) {
+		if( strcmp(argv[arg], "--mem") == 0 && arg+1 < argc ) {
+			mem_mb = atoll(argv[++arg]);
+		} else if( strcmp(argv[arg], "--tmp") == 0 && arg+1 < argc ) {
+			tmp_dir = argv[++arg];
+		} else if( strcmp(argv[arg], "--binary") == 0 ) {
+			binary = true;
+		} else {
+			break;
+		}
+	}
+	if(argc-arg !=2 || (argc > 1 && strncmp(argv[arg], "--", 2) == 0) ) {
+		cout << "usage:  ./edge_to_adj  [--mem MB] [--tmp dir] [--binary]  edgelist   adjlist" << endl;
+		cout << "  --mem MB    convert out of core, with MB of edge buffers" << endl;
+		cout << "  --tmp dir   directory for the sorted runs, default beside the output" << endl;
+		cout << "  --binary    write the binary CSR format instead of an adjacency list" << endl;
 		return -1;
 	}
 
-	string filename = argv[1];
-	string outfile = argv[2];
-
-	vector<pair<int, int> > edges;
-	map<int, vector<int> > adjlist1;
-	vector<pair<int, vector<int> > > adjlist2;
-
-	//read in and process an edgelist
-	read_edgelist(filename, edges);
-	edgelist_remove_duplicates(edges);
-	edgelist_remove_self_loops(edges);
+	string filename = argv[arg];
+	string outfile = argv[arg+1];
 
-	//make undirected adjlist
-	convert_edgelist_to_adjlist(edges, adjlist1);
-	adjlist_remove_reverse_edges(adjlist1);
-	convert_adjlist_to_edgelist(adjlist1, edges);
-	make_edgelist_undirected(edges);
-	convert_edgelist_to_adjlist(edges, adjlist1);
+	uint64 start = stage_time_ms();
 
-	//sort adjlist
-	adjlist_sort_rows(adjlist1);
+	if( mem_mb > 0 ) {
+		string tmp_prefix = outfile;
+		if( !tmp_dir.empty() ) {
+			size_t slash = outfile.find_last_of('/');
+			tmp_prefix = tmp_dir + "/" + (slash == string::npos ? outfile : outfile.substr(slash+1));
+		}
+		convert_edgelist_external(filename, outfile, mem_mb << 20, tmp_prefix + ".run", binary);
+		cout << "total " << stage_time_ms()-start << " ms" << endl;
+		return 0;
+	}
 
-	convert_adjlist_map_to_vec(adjlist1, adjlist2);
-	adjlist_relabel_verts_index_0(adjlist2);
-	adjlist_write_to_file(adjlist2, outfile);
+	vector<uint64> src, dst;
+	vector<int> isrc, idst, weights;
+	vector<uint64> keys;
+	vector<int> values;
+	vector<uint64> verts;
+
+	//read in and process an edgelist, indexed at 0
+	read_edgelist(filename, src, dst, weights);
+	edgelist_relabel_verts_index_0(src, dst, isrc, idst, verts);
+	canonicalize_edges(isrc, idst, weights, keys, values);
+	edgelist_sort(keys, values);
+	edgelist_remove_duplicates(keys, values);
+
+	//make undirected adjlist, rows sorted
+	make_edgelist_undirected(keys, values);
+	if( binary ) {
+		adjlist_write_binary(keys, values, verts, outfile);
+	} else {
+		adjlist_write_to_file(keys, values, verts.size(), outfile);
+	}
 
+	cout << "total " << stage_time_ms()-start << " ms" << endl;
 	return 0;
 }
-
-
-
-
-
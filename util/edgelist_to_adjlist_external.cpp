@@ -0,0 +1,563 @@
+/*
+	Out-of-core edgelist conversion,
+	edgelist_to_adjlist_external.cpp
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Converts an edgelist too large for memory, with the same
+	output as the in-memory conversion of
+	edgelist_to_adjlist_utils.cpp, in four passes:
+
+		0. the edgelist is streamed to collect the sorted
+		   vertex ids, a buffer of ids at a time
+		1. the edgelist is streamed again, relabeling each edge
+		   into a buffer of canonical edge keys that fits the
+		   memory cap; each full buffer is radix sorted,
+		   deduplicated, and spilled to disk as a sorted run
+		2. the runs are merged k ways, so duplicate and reverse
+		   edges meet and keep their smallest weight; both
+		   directions of each unique edge are buffered, sorted,
+		   and spilled again as runs of rows
+		3. the runs of rows are merged k ways, in row order, and
+		   each row is written as it is completed
+
+	Edges are only held in memory a buffer at a time.  The sorted
+	vertex ids are kept in memory, 8 bytes per vertex, to relabel
+	edges, as are the row offsets of binary output.
+
+	This software is distributed under
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#include<queue>
+#include<sys/stat.h>
+
+using namespace std;
+
+/* bytes of memory per edge in a run buffer: key, value, and radix sort copies */
+#define RUN_BYTES_PER_EDGE (2 * (sizeof(uint64) + sizeof(int)))
+
+/* records read at a time from each run, at least */
+#define MIN_RUN_BUFFER 4096
+
+/* an edgelist read a block at a time, see next_edge_line */
+struct EdgeStream {
+	FILE* file;
+	vector<char> text;
+	size_t begin;	// the next line in text
+	size_t len;		// bytes of text read
+	bool eof;
+};
+
+/* a sorted run of edge keys and values spilled to disk */
+struct EdgeRun {
+	string keys_name;
+	string values_name;
+	FILE* keys;
+	FILE* values;
+	vector<uint64> key_buf;
+	vector<int> value_buf;
+	size_t pos;
+	size_t len;
+	uint64 key;		// the run's current edge, at the head of the merge
+	int value;
+};
+
+/* the smallest current key among the runs, and its run */
+typedef pair<uint64, int> MergeHead;
+typedef priority_queue<MergeHead, vector<MergeHead>, greater<MergeHead> > MergeQueue;
+
+void open_edge_stream(string, EdgeStream&);
+bool next_edge_line(EdgeStream&, const char*&, const char*&);
+void spill_run(uint64*, int*, long long, string, vector<EdgeRun>&);
+void open_runs(vector<EdgeRun>&, long long, MergeQueue&);
+bool run_next(EdgeRun&);
+void close_run(EdgeRun&);
+bool merge_next(vector<EdgeRun>&, MergeQueue&, uint64&, int&);
+void sort_and_spill_rows(vector<uint64>&, vector<int>&, long long, string, vector<EdgeRun>&);
+void external_collect_verts(string, long long, vector<uint64>&);
+long long external_read_runs(string, long long, vector<uint64>&, string, vector<EdgeRun>&, bool&);
+long long external_merge_edges(vector<EdgeRun>&, long long, long long, string, vector<EdgeRun>&);
+void external_write_adjlist(vector<EdgeRun>&, long long, bool, string);
+void external_write_binary(vector<EdgeRun>&, long long, long long, vector<uint64>&, bool, string);
+void convert_edgelist_external(string, string, long long, string, bool);
+
+void open_edge_stream(string filename, EdgeStream& stream) {
+	stream.file = fopen( filename.c_str(), "rb" );
+	if( stream.file == NULL ) {
+		cout << "cannot open " << filename << endl;
+		exit(1);
+	}
+	stream.text.resize( 1 << 24 );
+	stream.begin = 0;
+	stream.len = 0;
+	stream.eof = false;
+}
+
+/*
+	Find the next line of the stream, from line to eol, reading
+	another block once the lines held are used up.  Lines are as
+	read_edgelist splits them.  Returns false, and closes the file,
+	at the end of the file
+*/
+bool next_edge_line(EdgeStream& stream, const char*& line, const char*& eol) {
+	while( true ) {
+		char* text = stream.text.data();
+		char* newline = (char*)memchr( text + stream.begin, '\n', stream.len - stream.begin );
+		if( newline != NULL || (stream.eof && stream.begin < stream.len) ) {
+			line = text + stream.begin;
+			eol = (newline != NULL) ? newline : text + stream.len;
+			stream.begin = eol - text + 1;
+			if( stream.begin > stream.len ) stream.begin = stream.len;
+			return true;
+		}
+		if( stream.eof ) {
+			fclose(stream.file);
+			return false;
+		}
+		// keep the partial line, and read after it
+		memmove( text, text + stream.begin, stream.len - stream.begin );
+		stream.len -= stream.begin;
+		stream.begin = 0;
+		if( stream.len == stream.text.size() ) {
+			cout << "edgelist line too long" << endl;
+			exit(1);
+		}
+		size_t got = fread( text + stream.len, 1, stream.text.size() - stream.len, stream.file );
+		stream.len += got;
+		stream.eof = ( got == 0 );
+	}
+}
+
+/*
+	Write n sorted keys and values as a run, named by prefix
+	and the run's index
+*/
+void spill_run(uint64* keys, int* values, long long n, string prefix, vector<EdgeRun>& runs) {
+
+	EdgeRun run;
+	char index[32];
+	snprintf(index, sizeof(index), "%d", (int)runs.size());
+	run.keys_name = prefix + index + ".keys";
+	run.values_name = prefix + index + ".values";
+	FILE* kf = fopen( run.keys_name.c_str(), "wb" );
+	FILE* vf = fopen( run.values_name.c_str(), "wb" );
+	bool ok = ( kf != NULL && vf != NULL );
+	ok = ok && ( fwrite( keys, sizeof(uint64), n, kf ) == size_t(n) );
+	ok = ok && ( fwrite( values, sizeof(int), n, vf ) == size_t(n) );
+	if( kf != NULL ) ok = ( fclose(kf) == 0 ) && ok;
+	if( vf != NULL ) ok = ( fclose(vf) == 0 ) && ok;
+	if( !ok ) {
+		cout << "cannot write run " << run.keys_name << endl;
+		exit(1);
+	}
+	run.keys = NULL;
+	run.values = NULL;
+	runs.push_back(run);
+}
+
+/*
+	Open runs to merge, each with a buffer of buffer_records,
+	and queue the first edge of each
+*/
+void open_runs(vector<EdgeRun>& runs, long long buffer_records, MergeQueue& heads) {
+	for(size_t r=0; r<runs.size(); r++) {
+		runs[r].keys = fopen( runs[r].keys_name.c_str(), "rb" );
+		runs[r].values = fopen( runs[r].values_name.c_str(), "rb" );
+		if( runs[r].keys == NULL || runs[r].values == NULL ) {
+			cout << "cannot read run " << runs[r].keys_name << endl;
+			exit(1);
+		}
+		runs[r].key_buf.resize(buffer_records);
+		runs[r].value_buf.resize(buffer_records);
+		runs[r].pos = 0;
+		runs[r].len = 0;
+		if( run_next(runs[r]) ) {
+			heads.push( MergeHead(runs[r].key, r) );
+		}
+	}
+}
+
+/*
+	Advance a run to its next edge, refilling its buffer.
+	Returns false at the end of the run
+*/
+bool run_next(EdgeRun& run) {
+	if( run.pos == run.len ) {
+		run.len = fread( run.key_buf.data(), sizeof(uint64), run.key_buf.size(), run.keys );
+		if( fread( run.value_buf.data(), sizeof(int), run.len, run.values ) != run.len ) {
+			cout << "short read of run " << run.values_name << endl;
+			exit(1);
+		}
+		run.pos = 0;
+		if( run.len == 0 ) {
+			return false;
+		}
+	}
+	run.key = run.key_buf[run.pos];
+	run.value = run.value_buf[run.pos];
+	run.pos++;
+	return true;
+}
+
+/* close a run and delete its files */
+void close_run(EdgeRun& run) {
+	if( run.keys != NULL ) fclose(run.keys);
+	if( run.values != NULL ) fclose(run.values);
+	remove( run.keys_name.c_str() );
+	remove( run.values_name.c_str() );
+	vector<uint64>().swap(run.key_buf);
+	vector<int>().swap(run.value_buf);
+}
+
+/*
+	Take the smallest edge from the merge of the runs.
+	Returns false once every run is exhausted
+*/
+bool merge_next(vector<EdgeRun>& runs, MergeQueue& heads, uint64& key, int& value) {
+	if( heads.empty() ) {
+		return false;
+	}
+	int r = heads.top().second;
+	heads.pop();
+	key = runs[r].key;
+	value = runs[r].value;
+	if( run_next(runs[r]) ) {
+		heads.push( MergeHead(runs[r].key, r) );
+	}
+	return true;
+}
+
+/* sort n directed edges and spill them as a run of rows */
+void sort_and_spill_rows(vector<uint64>& keys, vector<int>& values, long long n, string prefix, vector<EdgeRun>& runs) {
+	radix_sort( keys.data(), values.data(), n );
+	spill_run( keys.data(), values.data(), n, prefix, runs );
+}
+
+/*
+	Pass 0: stream the edgelist and collect the sorted ids of the
+	vertices on any edge other than a self loop, as
+	edgelist_relabel_verts_index_0 does.  Ids are buffered,
+	sorted, deduplicated, and merged into verts a buffer at a time
+*/
+void external_collect_verts(string filename, long long run_edges, vector<uint64>& verts) {
+
+	uint64 start = stage_time_ms();
+	EdgeStream stream;
+	open_edge_stream(filename, stream);
+	vector<uint64> ids(run_edges);
+	long long n = 0;
+	const char* line;
+	const char* eol;
+	bool more = true;
+	while( more ) {
+		more = next_edge_line(stream, line, eol);
+		if( more && *line != '#' ) {
+			uint64 v1, v2, weight;
+			parse_edge_line(line, eol, v1, v2, weight);
+			if( v1 != v2 ) {
+				ids[n++] = v1;
+				ids[n++] = v2;
+			}
+		}
+		if( n+2 > run_edges || (!more && n > 0) ) {
+			radix_sort( ids.data(), NULL, n );
+			n = unique_sorted( ids.data(), NULL, n );
+			vector<uint64> merged( verts.size() + n );
+			merged.resize( set_union( verts.begin(), verts.end(), ids.begin(), ids.begin()+n, merged.begin() ) - merged.begin() );
+			verts.swap(merged);
+			n = 0;
+		}
+	}
+	if( verts.size() >= INT_MAX ) {
+		cout << "too many vertices: " << verts.size() << endl;
+		exit(1);
+	}
+
+	cout << verts.size() << " verts found, " << stage_time_ms()-start << " ms" << endl;
+	return;
+}
+
+/*
+	Pass 1: stream the edgelist, parsing lines as read_edgelist
+	does, relabeling each edge by its position in verts into
+	buffers of run_edges canonical keys, see canonicalize_edges.
+	Each full buffer is sorted, deduplicated, and spilled as a run.
+	Returns the number of edges other than self loops
+*/
+long long external_read_runs(string filename, long long run_edges, vector<uint64>& verts, string prefix,
+		vector<EdgeRun>& runs, bool& weighted) {
+
+	uint64 start = stage_time_ms();
+	EdgeStream stream;
+	open_edge_stream(filename, stream);
+
+	vector<uint64> keys(run_edges);
+	vector<int> values(run_edges);
+	long long n = 0;
+	long long count = 0;
+	long long num_edges = 0;
+	long long num_self_loops = 0;
+	weighted = false;
+
+	const char* line;
+	const char* eol;
+	bool more = true;
+	while( more ) {
+		more = next_edge_line(stream, line, eol);
+		if( more ) {
+			count++;
+		}
+		if( more && *line != '#' ) {
+			uint64 v1, v2, weight;
+			parse_edge_line(line, eol, v1, v2, weight);
+			num_edges++;
+			if( weight != NO_WEIGHT ) weighted = true;
+			if( v1 == v2 ) {
+				num_self_loops++;
+			} else {
+				uint64 u = lower_bound( verts.begin(), verts.end(), v1 ) - verts.begin();
+				uint64 v = lower_bound( verts.begin(), verts.end(), v2 ) - verts.begin();
+				keys[n] = (u < v) ? (u << 32) | v : (v << 32) | u;
+				values[n] = (weight == NO_WEIGHT) ? 0 : weight-1;
+				n++;
+			}
+		}
+		if( n == run_edges || (!more && n > 0) ) {
+			radix_sort( keys.data(), values.data(), n );
+			n = unique_sorted( keys.data(), values.data(), n );
+			spill_run( keys.data(), values.data(), n, prefix, runs );
+			n = 0;
+		}
+	}
+
+	cout << "read " << count << " lines" << endl;
+	cout << num_edges << " edges, " << num_self_loops << " self loops removed" << endl;
+	cout << runs.size() << " sorted runs of up to " << run_edges << " edges spilled, " << stage_time_ms()-start << " ms" << endl;
+	return num_edges - num_self_loops;
+}
+
+/*
+	Pass 2: merge the runs of canonical keys, keeping each edge
+	once with its smallest weight, and spill both directions of
+	the unique edges as runs of rows, see make_edgelist_undirected.
+	Returns the number of unique edges
+*/
+long long external_merge_edges(vector<EdgeRun>& runs, long long run_edges, long long num_edges, string prefix,
+		vector<EdgeRun>& row_runs) {
+
+	uint64 start = stage_time_ms();
+	MergeQueue heads;
+	long long buffer_records = max( (long long)MIN_RUN_BUFFER, run_edges / (long long)max(runs.size(), (size_t)1) );
+	open_runs(runs, buffer_records, heads);
+
+	// half the memory for the merge buffers, half for the rows
+	long long row_edges = max( min(run_edges / 2, 2*num_edges), 2LL );
+	row_edges -= row_edges % 2;
+	vector<uint64> keys(row_edges);
+	vector<int> values(row_edges);
+	long long n = 0;
+	long long num_unique = 0;
+
+	uint64 key, next_key;
+	int value, next_value;
+	bool more = merge_next(runs, heads, key, value);
+	while( more ) {
+		// an edge listed more than once keeps its smallest weight
+		while( (more = merge_next(runs, heads, next_key, next_value)) && next_key == key ) {
+			value = min(value, next_value);
+		}
+		num_unique++;
+		value = value+1;
+		keys[n] = key;
+		values[n] = value;
+		keys[n+1] = (key << 32) | (key >> 32);
+		values[n+1] = value;
+		n += 2;
+		if( n == row_edges ) {
+			sort_and_spill_rows(keys, values, n, prefix + "rows", row_runs);
+			n = 0;
+		}
+		key = next_key;
+		value = next_value;
+	}
+	if( n > 0 ) {
+		sort_and_spill_rows(keys, values, n, prefix + "rows", row_runs);
+	}
+	for(size_t r=0; r<runs.size(); r++) {
+		close_run(runs[r]);
+	}
+
+	cout << num_edges - num_unique << " duplicate and reverse edges removed" << endl;
+	cout << num_unique << " edges, " << 2*num_unique << " total edges in " << row_runs.size() << " runs of rows, " << stage_time_ms()-start << " ms" << endl;
+	return num_unique;
+}
+
+/*
+	Pass 3: merge the runs of rows and write each row,
+	as adjlist_write_to_file does
+*/
+void external_write_adjlist(vector<EdgeRun>& row_runs, long long run_edges, bool weighted, string filename) {
+
+	uint64 start = stage_time_ms();
+	MergeQueue heads;
+	long long buffer_records = max( (long long)MIN_RUN_BUFFER, run_edges / (long long)max(row_runs.size(), (size_t)1) );
+	open_runs(row_runs, buffer_records, heads);
+
+	FILE* outfile = fopen( filename.c_str(), "w" );
+	if( outfile == NULL ) {
+		cout << "cannot write " << filename << endl;
+		exit(1);
+	}
+	const size_t flush_size = 1 << 22;
+	string out;
+	out.reserve( flush_size + 64 );
+	char buf[32];
+	long long count = 0;
+	int row = -1;
+	uint64 key;
+	int value;
+	while( merge_next(row_runs, heads, key, value) ) {
+		if( row < 0 || int(key >> 32) != row ) {
+			if( row >= 0 ) out.push_back('\n');
+			row = key >> 32;
+			out.append( buf, snprintf(buf, sizeof(buf), "%d ", row) );
+			count++;
+		} else {
+			out.push_back(' ');
+		}
+		int neighbor = (int)(key & 0xFFFFFFFFULL);
+		int len = weighted
+			? snprintf(buf, sizeof(buf), "%d:%d", neighbor, value)
+			: snprintf(buf, sizeof(buf), "%d", neighbor);
+		out.append( buf, len );
+		count++;
+		if( out.size() >= flush_size ) {
+			fwrite( out.data(), 1, out.size(), outfile );
+			out.clear();
+		}
+	}
+	if( row >= 0 ) out.push_back('\n');
+	fwrite( out.data(), 1, out.size(), outfile );
+	fclose(outfile);
+	for(size_t r=0; r<row_runs.size(); r++) {
+		close_run(row_runs[r]);
+	}
+
+	cout << count << " vert ids written to file, " << stage_time_ms()-start << " ms" << endl;
+	return;
+}
+
+/*
+	Pass 3, binary: merge the runs of rows into the binary CSR
+	format of graph_binary.h.  csr2 and the weights are streamed
+	to their places in the file, and csr1 is written last, with
+	the original ids of verts unless they are 0..n-1
+*/
+void external_write_binary(vector<EdgeRun>& row_runs, long long run_edges, long long num_edges,
+		vector<uint64>& verts, bool weighted, string filename) {
+
+	uint64 start = stage_time_ms();
+	int num_verts = verts.size();
+	bool relabeled = ( num_verts > 0 && verts[num_verts-1] != uint64(num_verts-1) );
+	if( num_edges > EID_MAX ) {
+		cout << "too many edges for 32-bit edge offsets: " << num_edges << ", rebuild with -DBC_WIDE_EDGES" << endl;
+		exit(1);
+	}
+	MergeQueue heads;
+	long long buffer_records = max( (long long)MIN_RUN_BUFFER, run_edges / (long long)max(row_runs.size(), (size_t)1) );
+	open_runs(row_runs, buffer_records, heads);
+
+	BCSR_header header;
+	init_binary_header( header, num_verts, num_edges, weighted, relabeled, "" );
+	string tmpfile = filename + ".tmp";
+	FILE* f = fopen( tmpfile.c_str(), "wb" );
+	FILE* wf = weighted ? fopen( tmpfile.c_str(), "r+b" ) : NULL;
+	if( f == NULL || (weighted && wf == NULL) ) {
+		cout << "cannot write " << filename << endl;
+		exit(1);
+	}
+	off_t csr2_offset = sizeof(header) + (off_t)(num_verts+1) * sizeof(eid_t);
+	bool ok = ( fseeko( f, csr2_offset, SEEK_SET ) == 0 );
+	if( weighted ) {
+		ok = ok && ( fseeko( wf, csr2_offset + (off_t)num_edges * sizeof(int), SEEK_SET ) == 0 );
+	}
+
+	vector<eid_t> csr1(num_verts+1, 0);
+	vector<int> csr2_buf;
+	vector<int> weight_buf;
+	csr2_buf.reserve(MIN_RUN_BUFFER);
+	weight_buf.reserve(MIN_RUN_BUFFER);
+	int row = -1;
+	long long edge = 0;
+	uint64 key;
+	int value;
+	while( merge_next(row_runs, heads, key, value) ) {
+		if( row < 0 || int(key >> 32) != row ) {
+			row = key >> 32;
+			csr1[row] = edge;
+		}
+		csr2_buf.push_back( (int)(key & 0xFFFFFFFFULL) );
+		if( weighted ) weight_buf.push_back(value);
+		edge++;
+		if( csr2_buf.size() == MIN_RUN_BUFFER ) {
+			ok = ok && ( fwrite( csr2_buf.data(), sizeof(int), csr2_buf.size(), f ) == csr2_buf.size() );
+			if( weighted ) ok = ok && ( fwrite( weight_buf.data(), sizeof(int), weight_buf.size(), wf ) == weight_buf.size() );
+			csr2_buf.clear();
+			weight_buf.clear();
+		}
+	}
+	ok = ok && ( fwrite( csr2_buf.data(), sizeof(int), csr2_buf.size(), f ) == csr2_buf.size() );
+	if( weighted ) ok = ok && ( fwrite( weight_buf.data(), sizeof(int), weight_buf.size(), wf ) == weight_buf.size() );
+	csr1[num_verts] = edge;
+
+	ok = ok && ( fseeko( f, 0, SEEK_SET ) == 0 );
+	ok = ok && ( fwrite( &header, sizeof(header), 1, f ) == 1 );
+	ok = ok && ( fwrite( csr1.data(), sizeof(eid_t), num_verts+1, f ) == size_t(num_verts+1) );
+	if( relabeled ) {
+		ok = ok && ( fseeko( f, binary_ids_offset( num_verts, num_edges, weighted ), SEEK_SET ) == 0 );
+		ok = ok && ( fwrite( verts.data(), sizeof(uint64), num_verts, f ) == size_t(num_verts) );
+	}
+	if( wf != NULL ) ok = ( fclose(wf) == 0 ) && ok;
+	ok = ( fclose(f) == 0 ) && ok;
+	ok = ok && ( rename( tmpfile.c_str(), filename.c_str() ) == 0 );
+	if( !ok ) {
+		remove( tmpfile.c_str() );
+		cout << "cannot write " << filename << endl;
+		exit(1);
+	}
+	for(size_t r=0; r<row_runs.size(); r++) {
+		close_run(row_runs[r]);
+	}
+
+	cout << num_verts << " verts and " << edge << " edges written to binary file, " << stage_time_ms()-start << " ms" << endl;
+	return;
+}
+
+/*
+	Convert an edgelist out of core, with edge buffers
+	of mem_bytes in all, spilling runs with names beginning
+	with tmp_prefix
+*/
+void convert_edgelist_external(string filename, string outfile, long long mem_bytes, string tmp_prefix, bool binary) {
+
+	long long run_edges = max( mem_bytes / (long long)RUN_BYTES_PER_EDGE, (long long)MIN_RUN_BUFFER );
+	// no bigger than the file needs, as a line of an edge has at least 4 bytes
+	struct stat st;
+	if( stat( filename.c_str(), &st ) == 0 ) {
+		run_edges = min( run_edges, max( (long long)st.st_size / 4 + 1, (long long)MIN_RUN_BUFFER ) );
+	}
+	vector<EdgeRun> runs;
+	vector<EdgeRun> row_runs;
+	vector<uint64> verts;
+	bool weighted;
+
+	external_collect_verts(filename, run_edges, verts);
+	long long num_edges = external_read_runs(filename, run_edges, verts, tmp_prefix, runs, weighted);
+	long long num_unique = external_merge_edges(runs, run_edges, num_edges, tmp_prefix, row_runs);
+	if( binary ) {
+		external_write_binary(row_runs, run_edges, 2*num_unique, verts, weighted, outfile);
+	} else {
+		external_write_adjlist(row_runs, run_edges, weighted, outfile);
+	}
+	return;
+}
@@ -1,333 +1,431 @@
 /*
-	Utility functions for preprocessing graphs, 
+	Utility functions for preprocessing graphs,
 	edgeslist_to_adjlist_utils.cpp.cpp
-	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>	
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
 
 	Convert the common graph representation of edgelist
 	to the adjacency format used by betweenness
 
-	This software is distributed under 
+	Edges are kept in flat arrays throughout.  Vertex ids may be
+	any unsigned 64-bit integers; they are relabeled 0..n-1 first,
+	by sorting and deduplicating them in parallel (see radix_sort.h)
+	and a binary search for each.  Each undirected edge is then
+	canonicalized to a 64-bit key, smaller label in the high 32 bits,
+	so one radix sort brings duplicate and reverse edges together,
+	and one pass removes them.  Both directions of every edge are
+	sorted again into the rows of the adjacency list.  Every stage
+	is O(m) or one O(m) radix sort, where the map based conversion
+	was quadratic in the degree.
+
+	This software is distributed under
 	the modified Berkeley Software Distribution (BSD) License.
 */
 
+#include<cstdio>
+#include<climits>
+#include<sys/time.h>
+#include<omp.h>
+
+#include "radix_sort.h"
+#include "graph_binary.h"
 
 using namespace std;
 
+/* weight value of an edge listed without one, see canonicalize_edges */
+#define NO_WEIGHT INT_MAX
+
 /* read */
-void read_edgelist(string, std::vector<pair<int, int> >&);
-pair<int,int> parse_edge(string);
-void edgelist_remove_duplicates(vector<pair<int, int> >&);
-void edgelist_remove_self_loops(vector<pair<int, int> >&);
-void convert_edgelist_to_adjlist(vector<pair<int, int> >&, map<int,vector<int> >&);
-void adjlist_remove_reverse_edges(map<int, vector<int> >&);
-void convert_adjlist_to_edgelist( map<int, vector<int> >&, vector<pair<int,int> >&);
-void make_edgelist_undirected( vector<pair<int, int> >& edgelist);
-void adjlist_sort_rows( map<int, vector<int> >& );
-void convert_adjlist_map_to_vec( map<int, vector<int> >&, vector<pair<int, vector<int> > >& );
-void adjlist_relabel_verts_index_0( vector<pair<int, vector<int> > >& );
-void adjlist_write_to_file( vector<pair<int, vector<int> > >&, string);
+void read_edgelist(string, vector<uint64>&, vector<uint64>&, vector<int>&);
+bool parse_edge_id(const char*&, const char*, uint64&);
+void parse_edge_line(const char*, const char*, uint64&, uint64&, uint64&);
+void edgelist_relabel_verts_index_0(vector<uint64>&, vector<uint64>&, vector<int>&, vector<int>&, vector<uint64>&);
+void canonicalize_edges(vector<int>&, vector<int>&, vector<int>&, vector<uint64>&, vector<int>&);
+void edgelist_sort(vector<uint64>&, vector<int>&);
+void edgelist_remove_duplicates(vector<uint64>&, vector<int>&);
+void make_edgelist_undirected(vector<uint64>&, vector<int>&);
+void adjlist_row_starts(vector<uint64>&, int, vector<long long>&);
+void adjlist_write_to_file(vector<uint64>&, vector<int>&, int, string);
+void adjlist_write_binary(vector<uint64>&, vector<int>&, vector<uint64>&, string);
+uint64 stage_time_ms();
+
+/* milliseconds, for the time of each stage */
+uint64 stage_time_ms() {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (uint64)tv.tv_sec*1000 + tv.tv_usec/1000;
+}
 
+/*
+	Parse an unsigned 64-bit integer at p as atoi does: leading
+	blanks, then digits, or 0 if there are none.  Advances p past it.
+	Returns false if it is negative or overflows
+*/
+bool parse_edge_id(const char* &p, const char* end, uint64 &id) {
+	while( p < end && (*p == ' ' || *p == '\t') ) p++;
+	if( p < end && *p == '-' ) {
+		return false;
+	}
+	if( p < end && *p == '+' ) p++;
+	bool overflow = false;
+	id = 0;
+	while( p < end && *p >= '0' && *p <= '9' ) {
+		uint64 digit = *p - '0';
+		overflow = overflow || id > (~0ULL - digit) / 10;
+		id = id*10 + digit;
+		p++;
+	}
+	return !overflow;
+}
+
+/*
+	Parse one edge line, ending at eol, into ids v1 and v2, and
+	the weight in the third column, or NO_WEIGHT if there is none.
+	A line of one id, or none, is a self loop.
+	Exits on a malformed line
+*/
+void parse_edge_line(const char* line, const char* eol, uint64 &v1, uint64 &v2, uint64 &weight) {
+	const char* q = line;
+	bool ok = parse_edge_id(q, eol, v1);
+	while( q < eol && (*q == ' ' || *q == '\t' || *q == '\r') ) q++;
+	v2 = v1;
+	if( q < eol ) {
+		ok = parse_edge_id(q, eol, v2) && ok;
+	}
+	while( q < eol && (*q == ' ' || *q == '\t' || *q == '\r') ) q++;
+	weight = NO_WEIGHT;
+	if( q < eol ) {
+		ok = parse_edge_id(q, eol, weight) && ok;
+		if( weight < 1 || weight >= (uint64)NO_WEIGHT ) {
+			cout << "bad edge weight: " << string(line, eol-line) << endl;
+			exit(1);
+		}
+	}
+	if( !ok ) {
+		cout << "bad edge: " << string(line, eol-line) << endl;
+		exit(1);
+	}
+}
 
 /**
 	Read in an edgelist file
-	Store in a vector of edges
+	Store the edges in flat arrays, src[i] to dst[i].
+	If lines have a third column, it is the edge weight;
+	edges listed without one have weight 1, as in the
+	edge list reader of betweenness, and weights is left
+	empty if no line has a weight.
+	Columns are separated by tabs or spaces
 **/
-void read_edgelist(string filename, std::vector<pair<int, int> >& edge_vec) {
-
-	std::ifstream edgelist;
-	edgelist.open(filename.c_str());
-	string line;
+void read_edgelist(string filename, vector<uint64>& src, vector<uint64>& dst, vector<int>& weights) {
 
-	pair<int,int> edge;
+	uint64 start = stage_time_ms();
+	ifstream edgelist( filename.c_str(), ios::in | ios::binary );
+	if( !edgelist ) {
+		cout << "cannot open " << filename << endl;
+		exit(1);
+	}
+	string text;
+	edgelist.seekg(0, ios::end);
+	text.resize( edgelist.tellg() );
+	edgelist.seekg(0, ios::beg);
+	edgelist.read( &text[0], text.size() );
+	edgelist.close();
 
-	int count=0;
-	while( getline(edgelist, line) ) {
+	const char* p = text.data();
+	const char* end = p + text.size();
+	long long count = 0;
+	bool weighted = false;
+	while( p < end ) {
+		const char* line = p;
+		const char* eol = p;
+		while( eol < end && *eol != '\n' ) eol++;
 		count++;
-		if(line[0]=='#') { //ignore comments at top of graphs from SNAP
-			//cout << "ignoring comment" << endl;
+		p = eol + 1;
+		if( *line == '#' ) { //ignore comments at top of graphs from SNAP
 			continue;
 		}
-		edge=parse_edge(line);
-		edge_vec.push_back(edge);
+		uint64 v1, v2, weight;
+		parse_edge_line(line, eol, v1, v2, weight);
+		if( weight != NO_WEIGHT && !weighted ) {
+			weights.assign( src.size(), 1 );
+			weighted = true;
+		}
+		src.push_back(v1);
+		dst.push_back(v2);
+		if( weighted ) weights.push_back( (weight == NO_WEIGHT) ? 1 : weight );
 	}
 
-	edgelist.close();
 	cout << "read " << count << " lines" << endl;
-	cout << edge_vec.size() << " edges" << endl;
+	cout << src.size() << " edges, " << stage_time_ms()-start << " ms" << endl;
 	return;
 }
 
 /*
-	Parse a row (edge) in an edgelist file
-	return the edge as a pair on ints
-*/
-pair<int,int> parse_edge(string edge_str) {
-
-	pair<int,int> edge;
-	int v1,v2;
-	int pos=edge_str.find("\t");
-	v1=atoi( edge_str.substr(0,pos).c_str() );
-	v2=atoi( edge_str.substr(pos+1,edge_str.length()).c_str() );
-	//cout << edge_str << endl;
-	//cout << v1 << " " << v2 << endl;
-	//cout << endl;
-	edge= make_pair(v1,v2);
-
-	return edge;
-}
-
-/*
-	Remove duplicate edges in an edge vector
-	Use sets to detect duplicates
-*/
-void edgelist_remove_duplicates(vector<pair<int, int> >& edgelist) {
-	set<pair<int, int> > edgelist_sans_duplicates;
-	pair< set<pair<int, int> >::const_iterator, bool> result_pair;
-	int num_duplicates=0;
-
-	vector<pair<int, int> >::iterator edge_itr;
-	
-	for(edge_itr=edgelist.begin(); edge_itr!=edgelist.end(); ++edge_itr) {
-		result_pair = edgelist_sans_duplicates.insert( *edge_itr );
-		if(!result_pair.second) num_duplicates++;
-	}	
-
-	set<pair<int, int> >::iterator set_itr;
-	edgelist.clear();
-	for(set_itr=edgelist_sans_duplicates.begin(); set_itr!=edgelist_sans_duplicates.end(); ++set_itr)
-		edgelist.push_back(*set_itr);
-
-	cout << num_duplicates << " duplicate edges removed" << endl;
-	return; 
-}
-
-/*
-	Remove self loops
-	Look for edges where vert1 == vert2
+	Relabel all vertices so the graph is indexed at 0, in
+	increasing order of id.  The ids on any edge other than a
+	self loop are sorted and deduplicated into verts, and each
+	id is replaced by its position in verts, found by binary
+	search, in the int arrays isrc and idst
 */
-void edgelist_remove_self_loops(vector<pair<int, int> >& edgelist) { 
-	int num_self_loops=0;
-	vector<pair<int, int> >::iterator edge_itr;
-	vector<pair<int, int> > edgelist_no_loops;
-
-	for(edge_itr= edgelist.begin(); edge_itr!= edgelist.end(); ++edge_itr) {
-		if ( (*edge_itr).first == (*edge_itr).second )
-			num_self_loops++;
-		else
-			edgelist_no_loops.push_back( (*edge_itr) );
+void edgelist_relabel_verts_index_0(vector<uint64>& src, vector<uint64>& dst, vector<int>& isrc, vector<int>& idst, vector<uint64>& verts) {
+
+	uint64 start = stage_time_ms();
+	long long m = src.size();
+
+	// a self loop adds no vertex; it repeats the ids of an edge that does
+	long long first = 0;
+	while( first < m && src[first] == dst[first] ) first++;
+	long long num_ids = (first < m) ? 2*m : 0;
+	verts.resize(num_ids);
+	#pragma omp parallel for
+	for(long long i=0; i<num_ids/2; i++) {
+		bool loop = ( src[i] == dst[i] );
+		verts[2*i] = loop ? src[first] : src[i];
+		verts[2*i+1] = loop ? dst[first] : dst[i];
+	}
+	radix_sort( verts.data(), NULL, num_ids );
+	long long n = unique_sorted( verts.data(), NULL, num_ids );
+	verts.resize(n);
+	if( n >= INT_MAX ) {
+		cout << "too many vertices: " << n << endl;
+		exit(1);
 	}
-	
-	edgelist=edgelist_no_loops;
-	cout << num_self_loops << " self loops removed" << endl;
-}
 
-/*
-	Convert an edgelist to an adjacency list.
-	Edgelist is vector of vert pairs,
-	Adjacency list is a map of vectors.
-*/
-void convert_edgelist_to_adjlist(vector<pair<int, int> >& edgelist, map<int,vector<int> >& adjlist) {
-
-	vector<pair<int, int> >::iterator edge_itr;
-	int v1,v2;
-	int count=0;
-	for(edge_itr=edgelist.begin(); edge_itr!=edgelist.end(); ++edge_itr) {
-		v1=(*edge_itr).first;
-		v2=(*edge_itr).second;
-		if( adjlist.find(v1) == adjlist.end() ) {
-			vector<int> row;
-			row.push_back(v2);
-			adjlist.insert( make_pair(v1, row) );
-		} else {
-			vector<int> row=(*(adjlist.find(v1))).second;
-			row.push_back(v2);
-			adjlist.erase(v1);
-			adjlist.insert( make_pair(v1,row) );
+	isrc.resize(m);
+	idst.resize(m);
+	#pragma omp parallel for
+	for(long long i=0; i<m; i++) {
+		if( src[i] == dst[i] ) {
+			isrc[i] = 0;
+			idst[i] = 0;
+			continue;
 		}
-		count ++;
-		//if(count%1000==0) cout << count << endl;
+		isrc[i] = lower_bound( verts.begin(), verts.end(), src[i] ) - verts.begin();
+		idst[i] = lower_bound( verts.begin(), verts.end(), dst[i] ) - verts.begin();
 	}
-	edgelist.clear();
-
-	cout << count << " edges converted to adjlist" << endl;
+	vector<uint64>().swap(src);
+	vector<uint64>().swap(dst);
 
+	cout << n << " verts relabelled, " << stage_time_ms()-start << " ms" << endl;
 	return;
 }
 
-
 /*
-	for each edge, find if a reverse exists
-	if so, remove the reverse, and keep the "first" edge found
+	Canonicalize every edge to a key, the smaller label in the
+	high 32 bits and the larger in the low, so an edge and its
+	reverse get the same key.  Self loops are removed.
+	A weight w is stored as w-1, so that unique_sorted, which keeps
+	the smallest value, keeps the smallest weight listed
 */
-void adjlist_remove_reverse_edges(map<int, vector<int> >& adjlist) { 
-
-	int num_reverse_edges_removed=0;
-	map<int,vector<int> >::iterator adj_itr;
-	for(adj_itr=adjlist.begin(); adj_itr!=adjlist.end(); ++adj_itr) {
-		int v=(*adj_itr).first;
-		vector<int> v_adj= adjlist[v];
-		vector<int>::iterator v_row_itr;
-		for(v_row_itr=v_adj.begin(); v_row_itr!=v_adj.end(); ++v_row_itr) {
-			int u=*v_row_itr;
-			if( adjlist.find(u) == adjlist.end() ) continue;
-			else {
-				vector<int> u_adj = adjlist[u];
-				vector<int>::iterator u_row_itr;
-				for(u_row_itr=u_adj.begin(); u_row_itr!=u_adj.end(); ++u_row_itr) {
-					if(*u_row_itr == v) {
-						num_reverse_edges_removed++;
-						vector<int> row_with_v = adjlist[u];
-						row_with_v.erase( find(row_with_v.begin(), row_with_v.end(), v) );
-						vector<int> row_without_v = row_with_v;
-						adjlist.erase(u);
-						adjlist.insert( make_pair( u, row_without_v) );
-					}
-				}
+void canonicalize_edges(vector<int>& src, vector<int>& dst, vector<int>& weights, vector<uint64>& keys, vector<int>& values) {
+
+	uint64 start = stage_time_ms();
+	long long m = src.size();
+	bool weighted = !weights.empty();
+
+	// keep the edges that are not self loops, in order
+	int num_threads = omp_get_max_threads();
+	vector<long long> offsets(num_threads+1, 0);
+	long long num_self_loops = 0;
+	#pragma omp parallel reduction(+:num_self_loops)
+	{
+		int t = omp_get_thread_num();
+		long long begin = m * t / num_threads;
+		long long finish = m * (t+1) / num_threads;
+		long long loops = 0;
+		for(long long i=begin; i<finish; i++) {
+			if( src[i] == dst[i] ) loops++;
+		}
+		offsets[t+1] = (finish-begin) - loops;
+		num_self_loops += loops;
+	}
+	for(int t=0; t<num_threads; t++) {
+		offsets[t+1] += offsets[t];
+	}
+
+	keys.resize( offsets[num_threads] );
+	if( weighted ) values.resize( offsets[num_threads] );
+	#pragma omp parallel
+	{
+		int t = omp_get_thread_num();
+		long long begin = m * t / num_threads;
+		long long finish = m * (t+1) / num_threads;
+		long long k = offsets[t];
+		for(long long i=begin; i<finish; i++) {
+			if( src[i] == dst[i] ) continue;
+			uint64 u = src[i];
+			uint64 v = dst[i];
+			keys[k] = (u < v) ? (u << 32) | v : (v << 32) | u;
+			if( weighted ) {
+				values[k] = weights[i]-1;
 			}
+			k++;
 		}
 	}
+	vector<int>().swap(src);
+	vector<int>().swap(dst);
+	vector<int>().swap(weights);
 
-	cout << num_reverse_edges_removed << " reverse edges removed" << endl;
+	cout << num_self_loops << " self loops removed, " << stage_time_ms()-start << " ms" << endl;
 	return;
 }
 
 /*
-	Convert an adjacency list to an edgelist
+	Sort the edge keys, with their weights, in parallel
 */
-void convert_adjlist_to_edgelist( map<int, vector<int> >& adjlist, vector<pair<int, int> >& edgelist) {
-	
-	edgelist.clear();
-	int edges_processed=0;
-
-	map<int, vector<int> >::iterator adj_itr;
-	vector<int>::iterator row_itr;
-
-	for(adj_itr=adjlist.begin(); adj_itr!=adjlist.end(); ++adj_itr) {
-		for(row_itr=((*adj_itr).second).begin(); row_itr!=((*adj_itr).second).end(); ++row_itr) {
-			edgelist.push_back( make_pair( (*adj_itr).first, *row_itr) );
-			edges_processed++;
-		}
-	}
-
-	adjlist.clear();
-	cout << edges_processed << " edges coverted to edgelist" << endl;
+void edgelist_sort(vector<uint64>& keys, vector<int>& values) {
+	uint64 start = stage_time_ms();
+	radix_sort( keys.data(), values.empty() ? NULL : values.data(), keys.size() );
+	cout << keys.size() << " edges sorted, " << stage_time_ms()-start << " ms" << endl;
 	return;
 }
 
 /*
-	Make an edgelist undirected.
-	Input edgelist contains no duplicates,
-	so iterate through the input vector,
-	add the reverse to a new vector,
-	then iterate through the new vector
-	and add to the original vec
+	Remove duplicate edges from sorted keys: an edge listed
+	twice, in either direction, keeps its smallest weight.
+	Weights are then restored from w-1
 */
-void make_edgelist_undirected( vector<pair<int, int> >& edgelist) {
-
-
-	vector<pair<int, int> >::iterator edge_itr;
-	vector<pair<int, int> > reverse_edges;
-	for( edge_itr=edgelist.begin(); edge_itr != edgelist.end(); ++edge_itr) {
-		reverse_edges.push_back( make_pair( (*edge_itr).second, (*edge_itr).first) );
-	}
-	for( edge_itr=reverse_edges.begin(); edge_itr != reverse_edges.end(); ++edge_itr) {
-		edgelist.push_back( *edge_itr );
+void edgelist_remove_duplicates(vector<uint64>& keys, vector<int>& values) {
+
+	uint64 start = stage_time_ms();
+	long long m = keys.size();
+	long long unique = unique_sorted( keys.data(), values.empty() ? NULL : values.data(), m );
+	keys.resize(unique);
+	if( !values.empty() ) {
+		values.resize(unique);
+		#pragma omp parallel for
+		for(long long i=0; i<unique; i++) {
+			values[i] = values[i]+1;
+		}
 	}
 
-	cout << reverse_edges.size() << " edges added, " << edgelist.size() << " total edges" << endl;
+	cout << m-unique << " duplicate and reverse edges removed, " << stage_time_ms()-start << " ms" << endl;
 	return;
 }
 
 /*
-	Sort each row of an adjacency list
+	Make an edgelist undirected.
+	Input keys contain no duplicates, so append the reverse
+	of every edge, then sort the keys again, which orders them
+	by row and within each row by neighbor
 */
-void adjlist_sort_rows( map<int, vector<int> >& adjlist) {
-	int num_rows_sorted=0;
-	for( map<int, vector<int> >::iterator adj_itr = adjlist.begin(); adj_itr!= adjlist.end(); ++adj_itr) {
-		sort( ((*adj_itr).second).begin(), ((*adj_itr).second).end() );
-		num_rows_sorted++;
+void make_edgelist_undirected(vector<uint64>& keys, vector<int>& values) {
+
+	uint64 start = stage_time_ms();
+	long long m = keys.size();
+	keys.resize(2*m);
+	if( !values.empty() ) values.resize(2*m);
+	#pragma omp parallel for
+	for(long long i=0; i<m; i++) {
+		keys[m+i] = (keys[i] << 32) | (keys[i] >> 32);
+		if( !values.empty() ) values[m+i] = values[i];
 	}
-	cout << num_rows_sorted << " rows of adjlist sorted" << endl;
+	radix_sort( keys.data(), values.empty() ? NULL : values.data(), keys.size() );
+
+	cout << m << " edges added, " << keys.size() << " total edges, " << stage_time_ms()-start << " ms" << endl;
 	return;
 }
 
 /*
-	Convert an adjacency list from a map representation to 
-	vector of vectors representation
+	Find where each row starts in sorted keys, which is where
+	the high id of the key changes; every vertex has a row
 */
-void convert_adjlist_map_to_vec( map<int, vector<int> >& adjlist, vector<pair<int, vector<int> > >& adjlist_vec) {
-	for( map<int, vector<int> >::iterator adj_itr=adjlist.begin(); adj_itr!= adjlist.end(); ++adj_itr) {
-		adjlist_vec.push_back( make_pair( (*adj_itr).first, (*adj_itr).second) );
+void adjlist_row_starts(vector<uint64>& keys, int num_verts, vector<long long>& row_start) {
+	long long m = keys.size();
+	row_start.assign(num_verts+1, m);
+	#pragma omp parallel for
+	for(long long i=0; i<m; i++) {
+		if( i == 0 || (keys[i] >> 32) != (keys[i-1] >> 32) ) {
+			row_start[keys[i] >> 32] = i;
+		}
 	}
-	adjlist.clear();
-	cout << adjlist_vec.size() << " verts in new adjlist" << endl;
-	return;
 }
 
 /*
-	Relabel all vertices of an adjacency list so the 
-	graph is indexed at 0
+	Write an adjacency list to file from sorted keys,
+	as neighbor:weight if values are given.
+	Blocks of rows are formatted in parallel, then written in order
 */
-void adjlist_relabel_verts_index_0( vector<pair<int, vector<int> > >& adjlist) {
-
-	map<int, int> vert_relabel;
-	int v;
-	int v_relabel = 0;
-	int relabel_count=0;
-
-	// create map of new labels
-	vector<pair<int, vector<int> > >::iterator adj_itr;
-	for( adj_itr = adjlist.begin(); adj_itr != adjlist.end(); ++adj_itr) {
-		v = (*adj_itr).first;
-		vert_relabel.insert( make_pair(v, v_relabel) );
-		v_relabel++;
-	}
+void adjlist_write_to_file(vector<uint64>& keys, vector<int>& values, int num_verts, string filename) {
+
+	uint64 start = stage_time_ms();
+	long long m = keys.size();
+	bool weighted = !values.empty();
 
-	// relabel all verts
-	vector<int> row, row_relabel;
-	for(int i=0; i<adjlist.size(); i++) {
-		v = adjlist[i].first;	 
-		adjlist[i].first = vert_relabel[v];
-		relabel_count++;
+	vector<long long> row_start;
+	adjlist_row_starts(keys, num_verts, row_start);
 
-		for(int j=0; j<(adjlist[i].second).size(); j++) {
-			(adjlist[i].second)[j] = vert_relabel[ (adjlist[i].second)[j] ];
-			relabel_count++;
+	FILE* outfile = fopen( filename.c_str(), "w" );
+	if( outfile == NULL ) {
+		cout << "cannot write " << filename << endl;
+		exit(1);
+	}
+	const int block_rows = 1 << 14;
+	int num_blocks = (num_verts + block_rows - 1) / block_rows;
+	int batch = 4 * omp_get_max_threads();
+	vector<string> text(batch);
+	for(int first=0; first<num_blocks; first+=batch) {
+		int last = min(num_blocks, first+batch);
+		#pragma omp parallel for schedule(dynamic, 1)
+		for(int b=first; b<last; b++) {
+			string &out = text[b-first];
+			out.clear();
+			char buf[32];
+			int row_end = min(num_verts, (b+1)*block_rows);
+			for(int v=b*block_rows; v<row_end; v++) {
+				out.append( buf, snprintf(buf, sizeof(buf), "%d ", v) );
+				for(long long e=row_start[v]; e<row_start[v+1]; e++) {
+					int len = weighted
+						? snprintf(buf, sizeof(buf), "%d:%d", (int)(keys[e] & 0xFFFFFFFFULL), values[e])
+						: snprintf(buf, sizeof(buf), "%d", (int)(keys[e] & 0xFFFFFFFFULL));
+					out.append( buf, len );
+					if( e+1 < row_start[v+1] ) out.push_back(' ');
+				}
+				out.push_back('\n');
+			}
+		}
+		for(int b=first; b<last; b++) {
+			fwrite( text[b-first].data(), 1, text[b-first].size(), outfile );
 		}
 	}
+	fclose(outfile);
 
-	cout << relabel_count << " vert_ids relabelled" << endl;
+	cout << num_verts + m << " vert ids written to file, " << stage_time_ms()-start << " ms" << endl;
 	return;
 }
 
 /*
-	Write an adjacency list to file
+	Write the graph from sorted keys in the binary CSR format
+	of graph_binary.h, instead of as an adjacency list,
+	with the original ids of verts unless they are 0..n-1
 */
-void adjlist_write_to_file( vector<pair<int, vector<int> > >& adjvec, string filename) {
-
-	int count=0;
-	ofstream outfile;
-	outfile.open( filename.c_str() );
-	for( vector<pair<int, vector<int> > >::iterator adjv_itr = adjvec.begin(); adjv_itr!=adjvec.end(); ++adjv_itr) {
-		outfile << (*adjv_itr).first << " ";
-		count++;
-		for( vector<int>::iterator row_itr = ((*adjv_itr).second).begin(); row_itr != ((*adjv_itr).second).end(); ++row_itr) {
-			outfile << *row_itr;
-			count++;
-			if( (row_itr+1)!= ((*adjv_itr).second).end() ) outfile << " ";
-		}
-		outfile << endl;
+void adjlist_write_binary(vector<uint64>& keys, vector<int>& values, vector<uint64>& verts, string filename) {
+
+	uint64 start = stage_time_ms();
+	int num_verts = verts.size();
+	bool relabeled = ( num_verts > 0 && verts[num_verts-1] != uint64(num_verts-1) );
+	long long m = keys.size();
+	if( m > EID_MAX ) {
+		cout << "too many edges for 32-bit edge offsets: " << m << ", rebuild with -DBC_WIDE_EDGES" << endl;
+		exit(1);
+	}
+	vector<long long> row_start;
+	adjlist_row_starts(keys, num_verts, row_start);
+
+	vector<eid_t> csr1(num_verts+1);
+	vector<int> csr2(m);
+	#pragma omp parallel for
+	for(int v=0; v<=num_verts; v++) {
+		csr1[v] = row_start[v];
+	}
+	#pragma omp parallel for
+	for(long long i=0; i<m; i++) {
+		csr2[i] = (int)(keys[i] & 0xFFFFFFFFULL);
+	}
+	if( !write_binary_graph( filename, num_verts, m, csr1.data(), csr2.data(), values.empty() ? NULL : values.data(), relabeled ? verts.data() : NULL, "" ) ) {
+		cout << "cannot write " << filename << endl;
+		exit(1);
 	}
-	outfile.close();
 
-	cout << count << " vert ids written to file" << endl;
+	cout << num_verts << " verts and " << m << " edges written to binary file, " << stage_time_ms()-start << " ms" << endl;
 	return;
 }
-
-
-
-
-
-
-
-
@@ -0,0 +1,126 @@
+/*
+	Brandes workspace implementation, workspace.cpp
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Allocates the per-source arrays of Brandes once,
+	and resets them between sources
+
+	This software is distributed under 
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#include<cstdio>
+#include<cstdlib>
+
+#include "workspace.h"
+
+Workspace::Workspace(int sz) {
+	num_verts = sz;
+	num_touched = 0;
+	queue = new int[num_verts];
+	dist = new int[num_verts];
+	num_paths = new sigma_t[num_verts];
+	delta = new float[num_verts];
+	levels = NULL;
+	num_levels = 0;
+	levels_capacity = 0;
+	reset_all();
+}
+
+Workspace::~Workspace() {
+	delete [] queue;
+	delete [] dist;
+	delete [] num_paths;
+	delete [] delta;
+	free(levels);
+}
+
+/*
+	Restore the nodes reached by the last search,
+	the first num_touched entries of the queue
+*/
+void Workspace::reset() {
+	for(int i=0; i<num_touched; i++) {
+		int v = queue[i];
+		dist[v] = -1;
+		num_paths[v] = 0;
+		delta[v] = 0.0;
+	}
+	num_touched = 0;
+}
+
+/* restore every node, for searches that do not fill the queue */
+void Workspace::reset_all() {
+	for(int i=0; i<num_verts; i++) {
+		dist[i] = -1;
+		num_paths[i] = 0;
+		delta[i] = 0.0;
+	}
+	num_touched = 0;
+}
+
+int* Workspace::get_queue() {
+	return queue;
+}
+
+int* Workspace::get_dist() {
+	return dist;
+}
+
+sigma_t* Workspace::get_num_paths() {
+	return num_paths;
+}
+
+float* Workspace::get_delta() {
+	return delta;
+}
+
+int Workspace::get_num_touched() {
+	return num_touched;
+}
+
+void Workspace::set_num_touched(int n) {
+	num_touched = n;
+}
+
+/*
+	Count one expansion of BFS level l, bottom_up or top-down,
+	that examined edges, where top-down would examine frontier_edges
+*/
+void Workspace::add_level(int l, bool bottom_up, long long examined, long long frontier_edges) {
+	if( l >= levels_capacity ) {
+		int new_capacity = (levels_capacity == 0) ? 16 : levels_capacity;
+		while( new_capacity <= l ) {
+			new_capacity *= 2;
+		}
+		levels = (BFS_level*)realloc( levels, new_capacity*sizeof(BFS_level) );
+		if( levels == NULL ) {
+			printf("bad Workspace realloc of levels: %d\n", new_capacity);
+			exit(1);
+		}
+		for(int i=levels_capacity; i<new_capacity; i++) {
+			levels[i].searches = 0;
+			levels[i].bottom_up = 0;
+			levels[i].examined = 0;
+			levels[i].frontier_edges = 0;
+		}
+		levels_capacity = new_capacity;
+	}
+	if( l >= num_levels ) {
+		num_levels = l+1;
+	}
+	levels[l].searches++;
+	if( bottom_up ) {
+		levels[l].bottom_up++;
+	}
+	levels[l].examined += examined;
+	levels[l].frontier_edges += frontier_edges;
+}
+
+BFS_level* Workspace::get_levels() {
+	return levels;
+}
+
+int Workspace::get_num_levels() {
+	return num_levels;
+}
@@ -0,0 +1,86 @@
+/*
+	Brandes workspace header, workspace.h
+	Copyright 2023, Ryan McCune	<robertryanmccune@gmail.com>
+
+	Per-thread scratch space for the single-source phase of Brandes.
+	A Workspace is allocated once per thread and reused for
+	every source the thread processes, so no memory is allocated
+	inside the per-source loop.
+
+	Members:
+
+		queue - the FIFO frontier, which is also the order of discovery.
+		after a search, queue[0..num_touched) lists every node reached
+
+		dist - distance from the source, -1 when unreached
+
+		num_paths - number of shortest paths from the source, a sigma_t,
+		floating point so counts that pass 2^31 lose precision
+		rather than wrap, see graph_types.h
+
+		delta - dependency of the source on each node
+
+		levels - per BFS level, the searches that reached it, how
+		many of them expanded it bottom-up, the edges they examined,
+		and the edges a top-down expansion would have examined,
+		summed over the sources searched with the Workspace
+
+	No shortest path parents are stored; the engines re-derive
+	them from dist and the graph's csr2 rows when needed,
+	so a Workspace is a few flat arrays of num_verts entries.
+
+	Between sources, reset() restores only the nodes in queue[0..num_touched),
+	so the cost of a reset is the size of the previous search, not num_verts.
+
+	This software is distributed under 
+	the modified Berkeley Software Distribution (BSD) License.
+*/
+
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include "graph_types.h"
+
+struct BFS_level {
+	long long searches;
+	long long bottom_up;
+	long long examined;
+	long long frontier_edges;
+};
+
+class Workspace {
+
+	public:
+		Workspace(int);
+		~Workspace();
+
+		void reset();
+		void reset_all();
+
+		int* get_queue();
+		int* get_dist();
+		sigma_t* get_num_paths();
+		float* get_delta();
+
+		int get_num_touched();
+		void set_num_touched(int);
+
+		void add_level(int, bool, long long, long long);
+		BFS_level* get_levels();
+		int get_num_levels();
+
+	private:
+		int num_verts;
+		int num_touched;
+		int* queue;
+		int* dist;
+		sigma_t* num_paths;
+		float* delta;
+
+		BFS_level* levels;
+		int num_levels;
+		int levels_capacity;
+
+};
+
+#endif